@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <stdexcept>
 
@@ -8,6 +9,7 @@
 #include "data_structures/solution.hh"
 #include "reductions/reductions.hh"
 #include "solvers/branch_and_bound.hh"
+#include "solvers/distributed_branch_and_bound.hh"
 #include "solvers/greedy.hh"
 #include "solvers/greedylth.hh"
 #include "solvers/ordered.hh"
@@ -18,6 +20,19 @@
 
 int main(int argc, char **argv) {
   Config config = parse_params(argc, argv);
+  enable_stop_signals(config.time_limit);
+  if (!config.worker.empty()) {
+    // a worker only searches the subtrees it gets from the coordinator, it does not read a graph
+    DistributedBranchAndBound::work(config);
+    return 0;
+  }
+  if (!config.coordinator.empty()) {
+    DistributedBranchAndBound::listen(config);
+  }
+  if (!config.checkpoint_file.empty() && !config.resume) {
+    // start over, the searches of an old checkpoint are not continued
+    std::remove(config.checkpoint_file.c_str());
+  }
 
   graph g;
   g.read_from_stdin();
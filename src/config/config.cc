@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
 #include <stdexcept>
@@ -19,6 +20,23 @@ Config default_config = {
     .uncontraction_depth = 0,
     .search_depth = 0,
     .random = 0,
+    .threads = 1,
+    .candidate_threads = 1,
+    .order_contractions = false,
+    .decision_search = 0,
+    .normal_form = false,
+    .search_reductions = true,
+    .time_limit = 0,
+    .checkpoint_file = "",
+    .checkpoint_interval = 300,
+    .resume = false,
+    .coordinator = "",
+    .worker = "",
+    .best_first_memory = 0,
+    .sat_conflicts = 0,
+    .rolling_horizon = false,
+    .subgraph_threads = 0,
+    .subgraph_size = 14,
     .write_solution = false,
     .write_heuristic_solution = false,
 };
@@ -27,7 +45,7 @@ static const std::vector<std::string> strategy_names = {"solver", "greedy-bb", "
 static const std::vector<std::string> solver_names = {
     "greedy",          "greedylth", "ordered",      "red-deg-limit",
     "only-reductions", "bnb",       "treecontract", "red-deg-limit-random",
-    "greedy-strong",   "heuristic"};
+    "greedy-strong",   "heuristic", "greedy-lsh",   "sat"};
 
 Strategy parse_strategy(const std::string &arg) {
   for (size_t i = 0; i < strategy_names.size(); ++i) {
@@ -63,6 +81,39 @@ Config parse_params(int argc, char **argv) {
   struct arg_int *uncontr_depth = arg_int0("u", "uncontr-depth", NULL, "Uncontraction depth");
   struct arg_int *search_depth = arg_int0("d", "search-depth", NULL, "Search depth");
   struct arg_int *random = arg_int0(NULL, "random", "<0|1>", "Enable randomization");
+  struct arg_int *threads = arg_int0("t", "threads", NULL, "Number of threads for branch and bound");
+  struct arg_int *candidate_threads = arg_int0(NULL, "candidate-threads", NULL,
+                                               "Number of threads evaluating the contractions of each B&B node");
+  struct arg_int *order_contractions = arg_int0(NULL, "order-contractions", "<0|1>",
+                                                "Try the contractions of each B&B node by red degree, default 0");
+  struct arg_int *decision_search = arg_int0(NULL, "decision", "<0|1|2>",
+                                             "Exact search by decisions tww <= k, 1: increasing k, 2: bisection");
+  struct arg_int *normal_form = arg_int0(NULL, "normal-form", "<0|1>",
+                                         "Enumerate only B&B contraction sequences in Foata normal form");
+  struct arg_int *search_reductions = arg_int0(NULL, "search-reductions", "<0|1>",
+                                               "Contract twins and degree one nodes in B&B without branching");
+  struct arg_int *time_limit = arg_int0(NULL, "time-limit", "<seconds>",
+                                        "Stop and print the best solution after this time, also on SIGTERM");
+  struct arg_str *checkpoint_file = arg_str0(NULL, "checkpoint", "<file>",
+                                             "Write the state of the exact B&B to this file from time to time");
+  struct arg_int *checkpoint_interval =
+      arg_int0(NULL, "checkpoint-interval", "<seconds>", "Time between two checkpoints, default 300");
+  struct arg_int *resume =
+      arg_int0(NULL, "resume", "<0|1>", "Continue the B&B searches of the checkpoint file instead of starting over");
+  struct arg_str *coordinator = arg_str0(NULL, "coordinator", "<address>",
+                                         "Distribute the exact B&B to worker processes, host:port or a socket path");
+  struct arg_str *worker =
+      arg_str0(NULL, "worker", "<address>", "Search B&B subtrees for the coordinator at this address");
+  struct arg_int *best_first = arg_int0(NULL, "best-first", "<megabytes>",
+                                        "Expand B&B states by lowest lower bound, depth-first beyond this memory");
+  struct arg_int *sat_conflicts = arg_int0(NULL, "sat-conflicts", "<n>",
+                                           "Prove lower bounds by SAT decisions of n conflicts before the exact B&B");
+  struct arg_int *rolling_horizon = arg_int0(NULL, "rolling-horizon", "<0|1>",
+                                             "Greedy B&B commits one contraction per step and keeps the rest as plan");
+  struct arg_int *subgraph_threads = arg_int0(NULL, "subgraph-threads", "<n>",
+                                              "Prove lower bounds on induced subgraphs in n threads during exact B&B");
+  struct arg_int *subgraph_size =
+      arg_int0(NULL, "subgraph-size", "<n>", "Nodes of each induced subgraph proving a lower bound");
   // exact reductions
   struct arg_int *reduction_deg_zero = arg_int0(NULL, "red-deg-zero", "<0|1>", "Enable degree zero reduction");
   struct arg_int *reduction_deg_one = arg_int0(NULL, "red-deg-one", "<0|1>", "Enable degree one reduction");
@@ -96,6 +147,23 @@ Config parse_params(int argc, char **argv) {
                       reduction_red_deg_limit,
                       reduction_fast_twins,
                       random,
+                      threads,
+                      candidate_threads,
+                      order_contractions,
+                      decision_search,
+                      normal_form,
+                      search_reductions,
+                      time_limit,
+                      checkpoint_file,
+                      checkpoint_interval,
+                      resume,
+                      coordinator,
+                      worker,
+                      best_first,
+                      sat_conflicts,
+                      rolling_horizon,
+                      subgraph_threads,
+                      subgraph_size,
                       write_solution,
                       write_heuristic_solution,
                       end = arg_end(20)};
@@ -158,6 +226,57 @@ Config parse_params(int argc, char **argv) {
   if (random->count > 0) {
     config.random = random->ival[0];
   }
+  if (threads->count > 0) {
+    config.threads = std::max(threads->ival[0], 1);
+  }
+  if (candidate_threads->count > 0) {
+    config.candidate_threads = std::max(candidate_threads->ival[0], 1);
+  }
+  if (order_contractions->count > 0) {
+    config.order_contractions = order_contractions->ival[0];
+  }
+  if (decision_search->count > 0) {
+    config.decision_search = decision_search->ival[0];
+  }
+  if (normal_form->count > 0) {
+    config.normal_form = normal_form->ival[0];
+  }
+  if (search_reductions->count > 0) {
+    config.search_reductions = search_reductions->ival[0];
+  }
+  if (time_limit->count > 0) {
+    config.time_limit = std::max(time_limit->ival[0], 0);
+  }
+  if (checkpoint_file->count > 0) {
+    config.checkpoint_file = checkpoint_file->sval[0];
+  }
+  if (checkpoint_interval->count > 0) {
+    config.checkpoint_interval = std::max(checkpoint_interval->ival[0], 1);
+  }
+  if (resume->count > 0) {
+    config.resume = resume->ival[0];
+  }
+  if (coordinator->count > 0) {
+    config.coordinator = coordinator->sval[0];
+  }
+  if (worker->count > 0) {
+    config.worker = worker->sval[0];
+  }
+  if (best_first->count > 0) {
+    config.best_first_memory = std::max(best_first->ival[0], 0);
+  }
+  if (sat_conflicts->count > 0) {
+    config.sat_conflicts = std::max(sat_conflicts->ival[0], 0);
+  }
+  if (rolling_horizon->count > 0) {
+    config.rolling_horizon = rolling_horizon->ival[0];
+  }
+  if (subgraph_threads->count > 0) {
+    config.subgraph_threads = std::max(subgraph_threads->ival[0], 0);
+  }
+  if (subgraph_size->count > 0) {
+    config.subgraph_size = std::max(subgraph_size->ival[0], 2);
+  }
   // reductions
   if (reduction_deg_zero->count) {
     config.reductions.deg_zero = reduction_deg_zero->ival[0];
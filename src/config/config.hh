@@ -50,6 +50,24 @@ struct Config {
   int uncontraction_depth;
   int search_depth;
   bool random;
+  int threads;                  // Number of threads used by branch and bound
+  int candidate_threads;        // Number of threads evaluating the contractions of a branch and bound node, per thread
+  bool order_contractions;      // Try the contractions of a branch and bound node by increasing resulting red degree
+  int decision_search;          // 0: branch and bound lowers the heuristic tww, 1: decides tww <= k for increasing k,
+                                // 2: decides tww <= k by bisection
+  bool normal_form;             // Branch and bound only enumerates contraction sequences in Foata normal form
+  bool search_reductions;       // Branch and bound contracts twins and degree one nodes without branching
+  int time_limit;               // Seconds until the solvers stop and the best solution is printed, 0: no limit
+  std::string checkpoint_file;  // Branch and bound writes its state to this file from time to time, empty: never
+  int checkpoint_interval;      // Seconds between two checkpoints
+  bool resume;                  // Branch and bound continues the searches in the checkpoint file
+  std::string coordinator;      // Branch and bound hands its subtrees to worker processes connecting to this address
+  std::string worker;           // Searches subtrees for the coordinator at this address instead of solving the input
+  int best_first_memory;        // Megabytes for the states of a best-first branch and bound, 0: depth-first
+  int sat_conflicts;            // Conflicts of each SAT decision proving a lower bound before the exact B&B, 0: none
+  bool rolling_horizon;         // Greedy B&B commits only the first contraction of its plan and improves the rest
+  int subgraph_threads;         // Threads proving lower bounds on induced subgraphs during the exact B&B, 0: none
+  int subgraph_size;            // Nodes of each induced subgraph, whose tww is a lower bound
 
   bool write_solution;
   bool write_heuristic_solution;
@@ -18,6 +18,8 @@ enum Solver {
   RED_DEG_LIMIT_RANDOM = 7,
   GREEDY_STRONG = 8,
   HEURISTIC = 9,
+  GREEDY_LSH = 10,
+  SAT = 11,
 };
 
 enum Stop_Condition {
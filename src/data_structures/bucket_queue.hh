@@ -0,0 +1,55 @@
+#ifndef BUCKET_QUEUE_HH
+#define BUCKET_QUEUE_HH
+
+#include <vector>
+
+/**
+ * @brief Node ids bucketed by an integer key, e.g. the degree
+ *        insert, remove and update are O(1), the order inside a bucket is arbitrary
+ */
+class bucket_queue {
+public:
+  void init(unsigned int max_id, unsigned int max_key) {
+    buckets.assign(max_key + 1, std::vector<unsigned int>{});
+    keys.assign(max_id + 1, NONE);
+    positions.assign(max_id + 1, 0);
+  }
+
+  bool contains(unsigned int id) const { return keys[id] != NONE; }
+
+  unsigned int key(unsigned int id) const { return keys[id]; }
+
+  unsigned int max_key() const { return buckets.size() - 1; }
+
+  const std::vector<unsigned int> &bucket(unsigned int key) const { return buckets[key]; }
+
+  void insert(unsigned int id, unsigned int key) {
+    keys[id] = key;
+    positions[id] = buckets[key].size();
+    buckets[key].push_back(id);
+  }
+
+  void remove(unsigned int id) {
+    std::vector<unsigned int> &bucket{buckets[keys[id]]};
+    unsigned int last = bucket.back();
+    bucket[positions[id]] = last;
+    positions[last] = positions[id];
+    bucket.pop_back();
+    keys[id] = NONE;
+  }
+
+  void update(unsigned int id, unsigned int key) {
+    if (keys[id] == key) return;
+    remove(id);
+    insert(id, key);
+  }
+
+private:
+  static constexpr unsigned int NONE = -1;
+
+  std::vector<std::vector<unsigned int>> buckets;
+  std::vector<unsigned int> keys;
+  std::vector<unsigned int> positions;
+};
+
+#endif
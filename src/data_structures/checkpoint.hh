@@ -0,0 +1,188 @@
+#ifndef CHECKPOINT_HH
+#define CHECKPOINT_HH
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "graph.hh"
+#include "hash.hh"
+#include "solution.hh"
+
+/**
+ * @brief Subtree of a branch and bound search, given by the contractions leading to it and the position in its first
+ *        level, from which on the remaining contractions belong to it (see ContractionEnumeration::resume)
+ */
+struct SearchTask {
+  std::vector<Contraction> prefix;
+  std::vector<bool> prefix_forced;
+  unsigned int first;
+  unsigned int after;
+  // contractions of a precomputed level, see ContractionEnumeration::split
+  std::vector<Contraction> remaining{};
+  // the remaining contraction is forced, see ContractionEnumeration::force
+  bool remaining_forced{};
+};
+
+/**
+ * @brief File with the state of the branch and bound searches of a run, so an interrupted run can be resumed
+ *        a search is identified by the graph it starts at, its state is the incumbent and the subtrees, that are left
+ *        to explore, the file also keeps the finished searches, so a resumed run does not repeat them
+ *        the file is written to a temporary file first and then renamed, so it is complete at all times
+ */
+class Checkpoint {
+public:
+  struct Search {
+    uint64_t key;
+    bool finished{};
+    unsigned int tww{};
+    unsigned long long nodes{};
+    // contractions of the incumbent after the start of the search
+    std::vector<Contraction> solution{};
+    std::vector<SearchTask> tasks{};
+  };
+
+  /**
+   * @brief Reads the searches in the file, if it exists, and selects the search starting at the current state of g,
+   *        which is added, if the file does not contain it
+   */
+  Checkpoint(const std::string& _filename, graph& g) : filename(_filename) {
+    read();
+    uint64_t k = key(g);
+    current = 0;
+    while (current < searches.size() && searches[current].key != k) ++current;
+    resumed = current < searches.size();
+    if (!resumed) searches.push_back(Search{k});
+  }
+
+  // the file contained the selected search
+  bool resumed;
+
+  Search& search() { return searches[current]; }
+
+  /**
+   * @brief Replaces the file with the current state of all searches, a failed write keeps the previous file
+   *
+   * @return bool whether the file was written, an error is reported on stderr
+   */
+  bool write() {
+    std::string tmp = filename + ".tmp";
+    bool written;
+    {
+      std::ofstream file{tmp};
+      file << "c HeiTwin branch and bound checkpoint\n";
+      for (auto&& s : searches) {
+        file << "search " << s.key << " " << s.finished << " " << s.tww << " " << s.nodes << "\n";
+        file << "solution ";
+        write_contractions(file, s.solution);
+        file << "\n";
+        for (auto&& task : s.tasks) {
+          file << "task ";
+          write_task(file, task);
+          file << "\n";
+        }
+      }
+      file.close();
+      written = !file.fail();
+    }
+    if (!written) {
+      std::cerr << "c Cannot write checkpoint " << tmp << ": " << std::strerror(errno) << std::endl;
+      std::remove(tmp.c_str());
+      return false;
+    }
+    if (std::rename(tmp.c_str(), filename.c_str())) {
+      std::cerr << "c Cannot replace checkpoint " << filename << ": " << std::strerror(errno) << std::endl;
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Hash of the current state of g, including the node ids and edge colors
+   */
+  static uint64_t key(graph& g) {
+    uint64_t k = splitmix64(g.n);
+    for (node* u = g.get_first_node(); u; u = u->next) {
+      k = splitmix64(k ^ u->id);
+      for (auto&& e : *u) {
+        k = splitmix64(k ^ (uint64_t{e.target} << 1 | e.red));
+      }
+    }
+    return k;
+  }
+
+  // tasks and contractions in the format of the file, also used to send them to other processes
+  static void write_task(std::ostream& out, const SearchTask& task) {
+    write_contractions(out, task.prefix);
+    for (bool forced : task.prefix_forced) {
+      out << " " << forced;
+    }
+    out << " " << task.first << " " << task.after << " ";
+    write_contractions(out, task.remaining);
+    out << " " << task.remaining_forced;
+  }
+
+  static void read_task(std::istream& in, SearchTask& task) {
+    read_contractions(in, task.prefix);
+    task.prefix_forced.resize(task.prefix.size());
+    for (unsigned int i = 0; i < task.prefix.size(); ++i) {
+      bool forced;
+      in >> forced;
+      task.prefix_forced[i] = forced;
+    }
+    in >> task.first >> task.after;
+    read_contractions(in, task.remaining);
+    in >> task.remaining_forced;
+  }
+
+  static void write_contractions(std::ostream& out, const std::vector<Contraction>& contractions) {
+    out << contractions.size();
+    for (auto&& c : contractions) {
+      out << " " << c.u << " " << c.v;
+    }
+  }
+
+  static void read_contractions(std::istream& in, std::vector<Contraction>& contractions) {
+    unsigned int size = 0;
+    in >> size;
+    contractions.resize(size);
+    for (auto&& c : contractions) {
+      in >> c.u >> c.v;
+    }
+  }
+
+private:
+  std::string filename;
+  std::vector<Search> searches;
+  unsigned int current;
+
+  void read() {
+    std::ifstream file{filename};
+    std::string word;
+    while (file >> word) {
+      if (word == "search") {
+        Search s;
+        file >> s.key >> s.finished >> s.tww >> s.nodes;
+        searches.push_back(s);
+      } else if (word == "solution" && !searches.empty()) {
+        read_contractions(file, searches.back().solution);
+      } else if (word == "task" && !searches.empty()) {
+        SearchTask task;
+        read_task(file, task);
+        searches.back().tasks.push_back(task);
+      } else {
+        // comment
+        std::getline(file, word);
+      }
+    }
+  }
+
+};
+
+#endif /* end of include guard: CHECKPOINT_HH */
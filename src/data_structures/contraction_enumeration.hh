@@ -1,55 +1,127 @@
 #ifndef CONTRACTION_ENUMERATION_HH
 #define CONTRACTION_ENUMERATION_HH
 
+#include <algorithm>
+#include <climits>
 #include <list>
+#include <memory>
 #include <stack>
 #include <vector>
 
 #include "graph.hh"
+#include "hash.hh"
+#include "pair_scoring.hh"
+#include "thread_pool.hh"
 
 class ContractionEnumeration {
 public:
   // store next contraction at each level
   std::vector<std::pair<node*, node*>> next_contractions;
+  // candidates for the second node of the current first node at each level (see graph::two_hop_candidates), and
+  // the position of the current one
+  std::vector<std::vector<node*>> second_candidates;
+  std::vector<unsigned int> second_index;
+  // the remaining contractions of a level were handed to another enumeration (see split)
+  std::vector<bool> exhausted;
+  // the contraction of a level is the only one tried at it (see force)
+  std::vector<bool> forced;
+  // levels with enough nodes get all contractions passing the filters up front, computed by the thread pool, and
+  // the position of the current one, in ordered mode all levels are precomputed and sorted by score
+  std::vector<bool> precomputed;
+  std::vector<std::vector<std::pair<node*, node*>>> level_contractions;
+  std::vector<unsigned int> contraction_index;
+  std::vector<int> precomputed_limit;
   // store if pairs are independent at each level
   int level = 0;
+  // levels below are a fixed prefix, that is never backtracked (see resume)
+  int root_level = 0;
   int depth;
   int n;
 
-  ContractionEnumeration(graph& g, int _depth) : depth(_depth) {
+  /**
+   * @param g a graph
+   * @param _depth maximum number of contractions, 0 for no limit
+   * @param threads number of threads evaluating the contractions of a level with at least PARALLEL_MIN_NODES nodes
+   * @param _ordered the contractions of each level are tried by increasing red degree of the resulting node
+   * @param _normal_form only sequences in Foata normal form are enumerated, otherwise only consecutive independent
+   *                     contractions are ordered (see step_of)
+   */
+  ContractionEnumeration(graph& g, int _depth, unsigned int threads = 1, bool _ordered = false,
+                         bool _normal_form = false)
+      : depth(_depth), ordered(_ordered), normal_form(_normal_form), scoring(g) {
     next_contractions.resize(g.n, std::pair<node*, node*>{g.get_first_node(), g.get_first_node()});
+    second_candidates.resize(g.n);
+    second_index.resize(g.n, 0);
+    exhausted.resize(g.n, false);
+    forced.resize(g.n, false);
+    precomputed.resize(g.n, false);
+    level_contractions.resize(g.n);
+    contraction_index.resize(g.n, 0);
+    precomputed_limit.resize(g.n, 0);
+    step_begin.resize(g.n, 0);
+    step_keys.resize(g.n, 0);
     n = g.n;
+    g.enable_degree_buckets();
+    g.enable_partition_hash();
+    if (threads > 1 || ordered) {
+      if (threads > 1) pool = std::make_unique<ThreadPool>(threads);
+      for (unsigned int t = 0; t < std::max(threads, 1u); ++t) {
+        thread_scoring.emplace_back(g);
+      }
+      thread_candidates.resize(std::max(threads, 1u));
+    }
   }
 
   void skip_branch(graph& g) {
     g.uncontract();
+    scored = nullptr;
     level--;
   }
 
+  /**
+   * @brief Contracts the next pair of the enumeration, backtracking if necessary
+   *        only pairs keeping the maximum red degree below current_best are contracted, so a state, whose lookahead
+   *        bound (see lookahead_bound) reaches current_best, gets no children
+   *
+   * @return bool if there was a next contraction, otherwise the graph is back at the root level
+   */
   bool do_next_contraction(graph& g, int current_best) {
+    if (!current_best) {
+      // nothing is below a twin width of 0
+      while (level > root_level) {
+        g.uncontract();
+        --level;
+      }
+      scored = nullptr;
+      return false;
+    }
+    // a negative value means, that no solution is known yet
+    int limit = current_best < 0 ? current_best : current_best - 1;
     bool contracted = false;
     while (!contracted) {
       // backtrack until there is a next contraction
-      while (!increment_contraction(next_contractions[level], g)) {
-        if (g.n < n) {
+      while (!increment_contraction(next_contractions[level], g, limit)) {
+        if (level > root_level) {
           // backtrack
           g.uncontract();
+          scored = nullptr;
           --level;
         } else {
           // finished
           return false;
         }
       }
-      if (g.red_degree_in_limit(next_contractions[level].first, next_contractions[level].second, current_best)) {
-        // break symmetry
-        // if 1. not first contraction in graph, 2. next contraction > previous contraction, 3. contractions are
-        if (level > 0 && next_contractions[level].first->id > next_contractions[level - 1].first->id &&
-            g.contractions_independent(next_contractions[level], next_contractions[level - 1])) {
-          // independent, skip
-        } else {
+      if (red_degree_in_limit(next_contractions[level], limit)) {
+        // break symmetry, precomputed contractions are already filtered, but their step is needed
+        int step = forced[level] ? level : step_of(g, next_contractions[level]);
+        if (step >= 0) {
+          record_step(step);
           g.contract(next_contractions[level].first->id, next_contractions[level].second->id);
+          scored = nullptr;
           ++level;
           next_contractions[level] = std::pair<node*, node*>{g.get_first_node(), g.get_first_node()};
+          exhausted[level] = false;
+          forced[level] = false;
           contracted = true;
         }
       }
@@ -57,32 +129,391 @@ public:
     return true;
   }
 
+  /**
+   * @brief Lower bound on the twin width of every contraction sequence continuing the current state of g
+   *        each sequence starts with one of the pairs, so its twin width is at least the smallest maximum red degree
+   *        any single contraction leads to
+   *
+   * @param limit the bound is only determined below the limit
+   * @return int the bound, or at least limit if no contraction keeps the maximum red degree below it
+   */
+  static int lookahead_bound(graph& g, int limit) {
+    if (g.n <= 1) return std::min<int>(g.twin_width, limit);
+    g.enable_degree_buckets();
+    PairScoring scoring{g};
+    std::vector<node*> candidates;
+    auto exists_contraction = [&](int k) {
+      for (node* u = g.get_first_node(); u->next; u = u->next) {
+        g.two_hop_candidates(u, k, candidates);
+        if (candidates.empty()) continue;
+        scoring.mark(u, scoring_limit(k));
+        for (node* v : candidates) {
+          if (scoring.red_degree_in_limit(v, scoring_limit(k))) return true;
+        }
+      }
+      return false;
+    };
+    // binary search for the smallest maximum red degree in [twin width, limit]
+    int low = g.twin_width;
+    int high = limit;
+    while (low < high) {
+      int k = low + (high - low) / 2;
+      if (exists_contraction(k)) {
+        high = k;
+      } else {
+        low = k + 1;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Hash of the current search state
+   *        the partition determines the graph, which contractions pass the symmetry breaking (see step_of) is
+   *        determined by the first node of the last contraction and in normal form also by the nodes, that the
+   *        contractions of the last two steps were contracted into, so states with the same hash have the same subtree
+   *        nodes of the previous step, that were contracted by the last step, do not matter, as a contraction
+   *        independent of the last step is also independent of them
+   */
+  uint64_t state_hash(graph& g) {
+    // the symmetry breaking starts over at the root and after a forced contraction
+    if (level == 0 || forced[level - 1]) return g.partition_hash;
+    if (!normal_form) return g.partition_hash ^ (next_contractions[level - 1].first->id * 0x9e3779b97f4a7c15ULL);
+    int last_step = step_begin[level - 1];
+    uint64_t previous_step = 0x9e3779b97f4a7c15ULL;
+    if (last_step > 0 && !forced[last_step - 1]) {
+      for (int l = last_step - 1; l >= step_begin[last_step - 1]; --l) {
+        if (next_contractions[l].first->active) previous_step ^= splitmix64(next_contractions[l].first->id);
+      }
+    }
+    return g.partition_hash ^ splitmix64(step_keys[level - 1]) ^ splitmix64(previous_step) ^
+           (next_contractions[level - 1].first->id * 0x9e3779b97f4a7c15ULL);
+  }
+
+  /**
+   * @brief Continues the enumeration in a subtree, that was split off by another enumeration
+   *        the graph has to be in the state the enumeration was constructed with
+   *
+   * @param prefix contractions leading to the subtree, they are applied to g and never backtracked
+   * @param prefix_forced which contractions of the prefix were forced
+   * @param first first node of the next contraction at the level after the prefix
+   * @param after only second nodes with a larger id are tried for the first node
+   * @param remaining if not empty, exactly these contractions are tried at the level after the prefix
+   * @param remaining_forced the remaining contraction is forced (see force)
+   */
+  void resume(graph& g, const std::vector<Contraction>& prefix, const std::vector<bool>& prefix_forced,
+              unsigned int first, unsigned int after, int limit, const std::vector<Contraction>& remaining = {},
+              bool remaining_forced = false) {
+    level = 0;
+    for (auto&& c : prefix) {
+      next_contractions[level] = {&g.adj_list[c.u], &g.adj_list[c.v]};
+      forced[level] = prefix_forced[level];
+      record_step(forced[level] ? level : step_of(g, next_contractions[level]));
+      g.contract(c.u, c.v);
+      ++level;
+    }
+    root_level = level;
+    scored = nullptr;
+    exhausted[level] = false;
+    forced[level] = remaining_forced;
+    precomputed[level] = !remaining.empty();
+    if (precomputed[level]) {
+      std::vector<std::pair<node*, node*>>& contractions = level_contractions[level];
+      contractions.clear();
+      for (auto&& c : remaining) {
+        contractions.push_back({&g.adj_list[c.u], &g.adj_list[c.v]});
+      }
+      // incremented before the first use
+      contraction_index[level] = -1;
+      // the contractions were filtered with an unknown limit, check them again
+      precomputed_limit[level] = INT_MAX;
+      next_contractions[level] = {&g.adj_list[first], &g.adj_list[after]};
+      return;
+    }
+    std::vector<node*>& candidates = second_candidates[level];
+    g.two_hop_candidates(&g.adj_list[first], limit, candidates);
+    // increment_contraction continues after the position
+    second_index[level] =
+        std::upper_bound(candidates.begin(), candidates.end(), after, [](unsigned int id, node* v) { return id < v->id; }) -
+        candidates.begin() - 1;
+    next_contractions[level] = {&g.adj_list[first], &g.adj_list[after]};
+  }
+
+  /**
+   * @brief Hands the remaining contractions of the shallowest open level to another enumeration
+   *
+   * @param prefix contractions leading to the level
+   * @param prefix_forced which contractions of the prefix were forced
+   * @param first first node of the current contraction at the level
+   * @param after second node of the current contraction at the level
+   * @param remaining the remaining contractions of a precomputed level, empty otherwise
+   * @return bool if there was an open level
+   */
+  bool split(graph& g, std::vector<Contraction>& prefix, std::vector<bool>& prefix_forced, unsigned int& first,
+             unsigned int& after, std::vector<Contraction>& remaining) {
+    // only the current level can have a pending forced contraction
+    bool remaining_forced;
+    for (int l = root_level; l < level; ++l) {
+      if (take_level(g, l, prefix, prefix_forced, first, after, remaining, remaining_forced)) return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Hands everything left to enumerate to other enumerations, the open levels (see split) and the children of
+   *        the current state, the enumeration is finished afterwards
+   *        has to be called between two calls of do_next_contraction
+   *
+   * @param add called with prefix, prefix_forced, first, after, remaining and remaining_forced of each subtree (see
+   *            resume)
+   */
+  template <typename Add>
+  void suspend(graph& g, Add add) {
+    std::vector<Contraction> prefix;
+    std::vector<bool> prefix_forced;
+    unsigned int first, after;
+    std::vector<Contraction> remaining;
+    bool remaining_forced;
+    for (int l = root_level; l <= level; ++l) {
+      if (take_level(g, l, prefix, prefix_forced, first, after, remaining, remaining_forced)) {
+        add(prefix, prefix_forced, first, after, remaining, remaining_forced);
+      }
+    }
+  }
+
+  /**
+   * @brief Makes the contraction of u and v the only one tried at the current level
+   *        the contraction has to be safe, i.e. it does not increase any red degree and some optimal continuation of
+   *        the current state starts with it, the symmetry breaking starts over after it, as sequences, that would
+   *        reorder it with the following contractions, are not enumerated
+   */
+  void force(graph& g, unsigned int u, unsigned int v) {
+    if (u > v) std::swap(u, v);
+    forced[level] = true;
+    precomputed[level] = true;
+    level_contractions[level].assign(1, {&g.adj_list[u], &g.adj_list[v]});
+    // incremented before the first use
+    contraction_index[level] = -1;
+    precomputed_limit[level] = INT_MAX;
+    next_contractions[level] = level_contractions[level][0];
+  }
+
+  // levels with fewer nodes are not worth the synchronization
+  static constexpr unsigned int PARALLEL_MIN_NODES = 64;
+
 private:
-  bool increment_contraction(std::pair<node*, node*>& contraction, graph& g) {
+  bool ordered;
+  bool normal_form;
+  // level the step of the contraction at each level begins at, and the hash of the first nodes of the step so far
+  std::vector<int> step_begin;
+  std::vector<uint64_t> step_keys;
+  // the first node of the current level stays marked until the graph or the limit changes
+  PairScoring scoring;
+  node* scored = nullptr;
+  int scored_limit = 0;
+  // each thread of the pool scores with its own marks
+  std::unique_ptr<ThreadPool> pool;
+  std::vector<PairScoring> thread_scoring;
+  std::vector<std::vector<node*>> thread_candidates;
+  std::vector<node*> firsts;
+  std::vector<std::vector<std::pair<node*, node*>>> first_contractions;
+  std::vector<std::vector<unsigned int>> first_scores;
+  std::vector<std::pair<unsigned int, unsigned int>> order;
+  std::vector<std::pair<node*, node*>> unordered;
+
+  /**
+   * @brief Computes all contractions of the current level, that pass red_degree_in_limit and the symmetry breaking,
+   *        in parallel over the first node of the contraction, if there is a thread pool
+   *        in ordered mode they are sorted by the red degree of the resulting node, ties stay in node order
+   */
+  void precompute_contractions(graph& g, int limit) {
+    firsts.clear();
+    for (node* u = g.get_first_node(); u; u = u->next) {
+      firsts.push_back(u);
+    }
+    if (first_contractions.size() < firsts.size()) {
+      first_contractions.resize(firsts.size());
+      first_scores.resize(firsts.size());
+    }
+    auto evaluate = [&](unsigned int t, unsigned int i) {
+      node* u = firsts[i];
+      std::vector<std::pair<node*, node*>>& contractions = first_contractions[i];
+      contractions.clear();
+      first_scores[i].clear();
+      // graph::two_hop_candidates uses shared time stamps, the degree window is read-only
+      if (pool) {
+        g.degree_window(u, limit, thread_candidates[t]);
+      } else {
+        g.two_hop_candidates(u, limit, thread_candidates[t]);
+      }
+      if (thread_candidates[t].empty()) return;
+      thread_scoring[t].mark(u, scoring_limit(limit));
+      for (node* v : thread_candidates[t]) {
+        if (!thread_scoring[t].red_degree_in_limit(v, scoring_limit(limit))) continue;
+        if (step_of(g, {u, v}) < 0) continue;
+        contractions.push_back({u, v});
+        if (ordered) first_scores[i].push_back(thread_scoring[t].red_degree(v));
+      }
+    };
+    if (pool) {
+      pool->parallel_for(firsts.size(), evaluate);
+    } else {
+      for (unsigned int i = 0; i < firsts.size(); ++i) {
+        evaluate(0, i);
+      }
+    }
+    std::vector<std::pair<node*, node*>>& contractions = level_contractions[level];
+    contractions.clear();
+    for (unsigned int i = 0; i < firsts.size(); ++i) {
+      contractions.insert(contractions.end(), first_contractions[i].begin(), first_contractions[i].end());
+    }
+    if (ordered) {
+      order.clear();
+      for (unsigned int i = 0; i < firsts.size(); ++i) {
+        for (unsigned int score : first_scores[i]) {
+          order.push_back({score, order.size()});
+        }
+      }
+      std::sort(order.begin(), order.end());
+      unordered.swap(contractions);
+      contractions.clear();
+      for (auto&& [score, i] : order) {
+        contractions.push_back(unordered[i]);
+      }
+    }
+    precomputed_limit[level] = limit;
+  }
+
+  /**
+   * @brief Level the step of the contraction at the current level would begin at, in the Foata normal form
+   *        a sequence is in normal form, if it consists of steps of pairwise independent contractions, ordered by
+   *        decreasing first node, and each contraction depends on a contraction of the previous step, every class of
+   *        sequences, that only differ in the order of independent contractions, contains exactly one of them
+   *        independence is decided on the current graph, the contractions after the latest one the contraction depends
+   *        on are independent of it, so the neighborhood of its nodes did not change since then
+   *
+   *        without normal form, each contraction is its own step and it is only checked, that it does not belong before
+   *        the previous contraction, this leaves fewer different states for the transposition table to merge
+   *
+   * @return int the level, or -1 if the sequence would not be in normal form
+   */
+  int step_of(graph& g, std::pair<node*, node*> contraction) {
+    if (level == 0 || forced[level - 1]) return level;
+    if (!normal_form) {
+      std::pair<node*, node*> previous = next_contractions[level - 1];
+      return contraction.first->id > previous.first->id && g.contractions_independent(contraction, previous) ? -1
+                                                                                                              : level;
+    }
+    int last_step = step_begin[level - 1];
+    for (int l = level - 1; l >= last_step; --l) {
+      // depends on the last step, so it begins a new step
+      if (!g.contractions_independent(contraction, next_contractions[l])) return level;
+    }
+    // joins the last step, if it is the next in order and could not be moved to an earlier step
+    if (contraction.first->id > next_contractions[level - 1].first->id) return -1;
+    if (last_step == 0 || forced[last_step - 1]) return last_step;
+    for (int l = last_step - 1; l >= step_begin[last_step - 1]; --l) {
+      if (!g.contractions_independent(contraction, next_contractions[l])) return last_step;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Takes the remaining contractions of level l from this enumeration (see split), the current level may not
+   *        have started yet, then its subtree are the children of the current state
+   *
+   * @return bool if the level was open
+   */
+  bool take_level(graph& g, int l, std::vector<Contraction>& prefix, std::vector<bool>& prefix_forced,
+                  unsigned int& first, unsigned int& after, std::vector<Contraction>& remaining,
+                  bool& remaining_forced) {
+    if (exhausted[l]) return false;
+    exhausted[l] = true;
+    prefix.clear();
+    for (int i = 0; i < l; ++i) {
+      prefix.push_back({g.con_seq[i].u, g.con_seq[i].v});
+    }
+    prefix_forced.assign(forced.begin(), forced.begin() + l);
+    remaining.clear();
+    remaining_forced = forced[l];
+    first = next_contractions[l].first->id;
+    after = next_contractions[l].second->id;
+    // a level, that has not started, may still hold the precomputed contractions of an earlier state, a forced
+    // contraction never contracts a node with itself
+    if (precomputed[l] && first != after) {
+      // precomputed contractions are not in node order, hand them over explicitly
+      std::vector<std::pair<node*, node*>>& contractions = level_contractions[l];
+      for (unsigned int i = contraction_index[l] + 1; i < contractions.size(); ++i) {
+        remaining.push_back({contractions[i].first->id, contractions[i].second->id});
+      }
+      return !remaining.empty();
+    }
+    return true;
+  }
+
+  void record_step(int step) {
+    step_begin[level] = step;
+    step_keys[level] = (step == level ? 0 : step_keys[level - 1]) ^ splitmix64(next_contractions[level].first->id);
+  }
+
+  bool red_degree_in_limit(std::pair<node*, node*>& contraction, int limit) {
+    // precomputed contractions only have to be checked again, if the limit decreased since
+    if (precomputed[level] && precomputed_limit[level] == limit) return true;
+    if (scored != contraction.first || scored_limit != limit) {
+      scoring.mark(contraction.first, scoring_limit(limit));
+      scored = contraction.first;
+      scored_limit = limit;
+    }
+    return scoring.red_degree_in_limit(contraction.second, scoring_limit(limit));
+  }
+
+  // a negative limit means, that no solution is known yet, so no red degree exceeds it
+  static unsigned int scoring_limit(int limit) { return limit < 0 ? UINT_MAX : limit; }
+
+  bool increment_contraction(std::pair<node*, node*>& contraction, graph& g, int limit) {
     // depth limit
     if (depth && level == depth) return false;
+    if (exhausted[level]) return false;
     if (g.n <= 1) {
       // leaf
       return false;
     }
     if (contraction.first == contraction.second) {
       // special case: first contraction in level
-      contraction.second = contraction.second->next;
-      return true;
+      precomputed[level] = ordered || (pool && g.n >= PARALLEL_MIN_NODES);
+      if (precomputed[level]) {
+        precompute_contractions(g, limit);
+        contraction_index[level] = 0;
+      }
+    } else if (precomputed[level]) {
+      ++contraction_index[level];
     }
-    if (contraction.second->next) {
-      // increment second node
-      contraction.second = contraction.second->next;
+    if (precomputed[level]) {
+      if (contraction_index[level] == level_contractions[level].size()) return false;
+      contraction = level_contractions[level][contraction_index[level]];
       return true;
+    }
+
+    std::vector<node*>& candidates = second_candidates[level];
+    if (contraction.first == contraction.second) {
+      // special case: first contraction in level
+      g.two_hop_candidates(contraction.first, limit, candidates);
+      second_index[level] = 0;
     } else {
-      // second node is last node, increment first one
+      ++second_index[level];
+    }
+    // only nodes at distance <= 2 or far nodes passing a closed-form check can pass red_degree_in_limit
+    while (second_index[level] == candidates.size()) {
+      // second node is last candidate, increment first one
       contraction.first = contraction.first->next;
       if (!contraction.first->next) {
         return false;
       }
-      contraction.second = contraction.first->next;
-      return true;
+      g.two_hop_candidates(contraction.first, limit, candidates);
+      second_index[level] = 0;
     }
+    contraction.second = candidates[second_index[level]];
+    return true;
   }
 };
 
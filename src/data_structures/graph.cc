@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "hash.hh"
+
 int graph::get_node_degree(unsigned int v) const { return adj_list[v].deg; }
 
 int graph::get_red_node_degree(unsigned int v) const { return adj_list[v].num_red; }
@@ -40,6 +42,7 @@ void graph::contract(unsigned int u, unsigned int v) {
       v_ptr->other->prev->next = v_ptr->other->next;
       v_ptr->other->next->prev = v_ptr->other->prev;
       --adj_list[u_ptr->target].deg;
+      if (degree_buckets_enabled) degree_buckets.update(u_ptr->target, adj_list[u_ptr->target].deg);
       m -= 2;
       u_ptr = u_ptr->next;
       v_ptr = v_ptr->next;
@@ -165,6 +168,16 @@ void graph::contract(unsigned int u, unsigned int v) {
   adj_list[v].prev->next = adj_list[v].next;
   if (adj_list[v].next) adj_list[v].next->prev = adj_list[v].prev;
 
+  if (degree_buckets_enabled) {
+    degree_buckets.remove(v);
+    degree_buckets.update(u, adj_list[u].deg);
+  }
+
+  if (partition_hash_enabled) {
+    partition_hash ^= splitmix64(part_keys[u]) ^ splitmix64(part_keys[v]) ^ splitmix64(part_keys[u] ^ part_keys[v]);
+    part_keys[u] ^= part_keys[v];
+  }
+
   --n;
   if (adj_list[u].num_red > twin_width) twin_width = adj_list[u].num_red;
 }
@@ -185,6 +198,7 @@ void graph::uncontract(unsigned int steps) {
       }
       if (v_ptr->red) ++adj_list[v_ptr->target].num_red;
       ++adj_list[v_ptr->target].deg;
+      if (degree_buckets_enabled) degree_buckets.update(v_ptr->target, adj_list[v_ptr->target].deg);
       v_ptr->other->prev->next = v_ptr->other;
       v_ptr->other->next->prev = v_ptr->other;
       v_ptr = v_ptr->prev;
@@ -237,16 +251,35 @@ void graph::uncontract(unsigned int steps) {
     adj_list[con.v].prev->next = &adj_list[con.v];
     if (adj_list[con.v].next) adj_list[con.v].next->prev = &adj_list[con.v];
 
+    if (degree_buckets_enabled) {
+      degree_buckets.insert(con.v, adj_list[con.v].deg);
+      degree_buckets.update(con.u, adj_list[con.u].deg);
+    }
+
+    if (partition_hash_enabled) {
+      // the key of v is still stored
+      part_keys[con.u] ^= part_keys[con.v];
+      partition_hash ^=
+          splitmix64(part_keys[con.u]) ^ splitmix64(part_keys[con.v]) ^ splitmix64(part_keys[con.u] ^ part_keys[con.v]);
+    }
+
     con_seq.pop_back();
   }
 }
 
-bool graph::red_degree_in_limit(node *u, node *v, int limit) {
-  if (v->deg > u->deg) {
-    if (u->num_red + v->deg - u->deg > limit) return false;
-  } else {
-    if (v->num_red + u->deg - v->deg > limit) return false;
+bool graph::red_degree_in_limit(node *u, node *v, unsigned int limit) {
+  // the red neighbors of the node with the smaller degree stay red and the surplus neighbors of the other node become
+  // red, a red edge uv may be among the red neighbors, but disappears
+  node *smaller = v->deg > u->deg ? u : v;
+  node *larger = smaller == u ? v : u;
+  unsigned int uv_red = 0;
+  if (smaller->num_red) {
+    // the lists are sorted by target
+    for (edge *e = smaller->first; e->is_edge && e->target <= larger->id; e = e->next) {
+      if (e->target == larger->id && e->red) uv_red = 1;
+    }
   }
+  if (smaller->num_red - uv_red + larger->deg - smaller->deg > limit) return false;
 
   unsigned int red_deg = 0;
 
@@ -263,33 +296,42 @@ bool graph::red_degree_in_limit(node *u, node *v, int limit) {
     } else if (u_ptr->target == v_ptr->target) {
       // common neighbor
       if (u_ptr->red || v_ptr->red) {
-        ++red_deg;
+        if (++red_deg > limit) return false;
       }
       u_ptr = u_ptr->next;
       v_ptr = v_ptr->next;
     } else if (u_ptr->target < v_ptr->target) {
-      ++red_deg;
+      if (++red_deg > limit) return false;
       if (adj_list[u_ptr->target].num_red + (u_ptr->red ? 0 : 1) > limit) {
         return false;
       }
       u_ptr = u_ptr->next;
     } else {
-      ++red_deg;
+      if (++red_deg > limit) return false;
       if (adj_list[v_ptr->target].num_red + (v_ptr->red ? 0 : 1) > limit) {
         return false;
       }
       v_ptr = v_ptr->next;
     }
   }
+  // the edge uv may be in the tail of either list
   while (u_ptr->is_edge) {
-    ++red_deg;
+    if (u_ptr->target == v->id) {
+      u_ptr = u_ptr->next;
+      continue;
+    }
+    if (++red_deg > limit) return false;
     if (adj_list[u_ptr->target].num_red + (u_ptr->red ? 0 : 1) > limit) {
       return false;
     }
     u_ptr = u_ptr->next;
   }
   while (v_ptr->is_edge) {
-    ++red_deg;
+    if (v_ptr->target == u->id) {
+      v_ptr = v_ptr->next;
+      continue;
+    }
+    if (++red_deg > limit) return false;
     if (adj_list[v_ptr->target].num_red + (v_ptr->red ? 0 : 1) > limit) {
       return false;
     }
@@ -299,6 +341,117 @@ bool graph::red_degree_in_limit(node *u, node *v, int limit) {
   return red_deg <= limit;
 }
 
+void graph::enable_degree_buckets() {
+  if (degree_buckets_enabled) return;
+  degree_buckets_enabled = true;
+  degree_buckets.init(adj_list.size(), adj_list.size());
+  for (node *nd = get_first_node(); nd; nd = nd->next) {
+    degree_buckets.insert(nd->id, nd->deg);
+  }
+}
+
+void graph::enable_partition_hash() {
+  if (partition_hash_enabled) return;
+  partition_hash_enabled = true;
+  partition_hash = 0;
+  part_keys.resize(adj_list.size());
+  for (unsigned int id = 0; id < adj_list.size(); ++id) {
+    part_keys[id] = splitmix64(id + 0x9e3779b97f4a7c15ULL);
+  }
+  for (node *nd = get_first_node(); nd; nd = nd->next) {
+    partition_hash ^= splitmix64(part_keys[nd->id]);
+  }
+}
+
+void graph::degree_window(node *u, int limit, std::vector<node *> &candidates, unsigned int after, bool both_sides) {
+  // red_degree_in_limit rejects every pair with a degree difference above the limit
+  unsigned int width = limit < 0 ? degree_buckets.max_key() : std::min<unsigned int>(limit, degree_buckets.max_key());
+  unsigned int min_deg = u->deg > width ? u->deg - width : 0;
+  unsigned int max_deg = std::min(u->deg + width, degree_buckets.max_key());
+  // only nodes after u and after, unless both sides are requested
+  unsigned int min_id = both_sides ? 0 : std::max(after, u->id) + 1;
+  candidates.clear();
+  unsigned int size = 0;
+  for (unsigned int deg = min_deg; deg <= max_deg; ++deg) {
+    size += degree_buckets.bucket(deg).size();
+  }
+  if (4 * size > n) {
+    // wide window, walking the node list is cheaper than sorting
+    for (node *v = both_sides ? get_first_node() : u->next; v; v = v->next) {
+      if (v != u && v->id >= min_id && v->deg >= min_deg && v->deg <= max_deg) candidates.push_back(v);
+    }
+    return;
+  }
+  for (unsigned int deg = min_deg; deg <= max_deg; ++deg) {
+    for (unsigned int id : degree_buckets.bucket(deg)) {
+      if (id != u->id && id >= min_id) candidates.push_back(&adj_list[id]);
+    }
+  }
+  // keep the node list order
+  std::sort(candidates.begin(), candidates.end(), [](node *a, node *b) { return a->id < b->id; });
+}
+
+void graph::two_hop_candidates(node *u, int limit, std::vector<node *> &candidates) {
+  unsigned int width = limit < 0 ? degree_buckets.max_key() : std::min<unsigned int>(limit, degree_buckets.max_key());
+  unsigned int min_deg = u->deg > width ? u->deg - width : 0;
+  unsigned int max_deg = std::min(u->deg + width, degree_buckets.max_key());
+  if (visited.size() < adj_list.size()) visited.resize(adj_list.size(), 0);
+  if (!++visit_stamp) {
+    std::fill(visited.begin(), visited.end(), 0);
+    visit_stamp = 1;
+  }
+  candidates.clear();
+  visited[u->id] = visit_stamp;
+  unsigned int volume = 0;
+  for (auto &&e : *u) {
+    visited[e.target] = visit_stamp;
+    for (auto &&f : adj_list[e.target]) {
+      visited[f.target] = visit_stamp;
+    }
+    volume += adj_list[e.target].deg;
+  }
+  // pairs at distance > 2 get all their neighbors as red neighbors, these only pass if the red degree of no
+  // neighbor exceeds the limit
+  bool far_pairs = u->deg <= width && !has_critical_neighbor(u, limit);
+  auto passes = [&](node *v) {
+    if (v->deg < min_deg || v->deg > max_deg) return false;
+    if (visited[v->id] == visit_stamp) return true;
+    return far_pairs && u->deg + v->deg <= width && !has_critical_neighbor(v, limit);
+  };
+  if (8 * volume > n) {
+    // large 2-neighborhood, walking the node list is cheaper than sorting
+    for (node *v = u->next; v; v = v->next) {
+      if (passes(v)) candidates.push_back(v);
+    }
+    return;
+  }
+  for (auto &&e : *u) {
+    if (e.target > u->id && passes(&adj_list[e.target])) candidates.push_back(&adj_list[e.target]);
+    for (auto &&f : adj_list[e.target]) {
+      if (f.target > u->id && passes(&adj_list[f.target])) candidates.push_back(&adj_list[f.target]);
+    }
+  }
+  if (far_pairs) {
+    for (unsigned int deg = 0; deg <= width - u->deg; ++deg) {
+      for (unsigned int id : degree_buckets.bucket(deg)) {
+        if (id > u->id && visited[id] != visit_stamp && passes(&adj_list[id])) candidates.push_back(&adj_list[id]);
+      }
+    }
+  }
+  // keep the node list order, nodes with several common neighbors were added more than once
+  std::sort(candidates.begin(), candidates.end(), [](node *a, node *b) { return a->id < b->id; });
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+bool graph::has_critical_neighbor(node *u, int limit) {
+  // a negative limit means, that no solution is known yet
+  if (limit < 0) return false;
+  for (auto &&e : *u) {
+    if (adj_list[e.target].num_red + (e.red ? 0 : 1) > (unsigned int)limit) return true;
+  }
+  return false;
+}
+
 std::vector<unsigned int> split_and_parse(std::string &s) {
   std::vector<unsigned int> res;
   std::string tmp;
@@ -584,6 +737,207 @@ void graph::read_complement(graph &g) {
   }
 }
 
+void graph::copy_from(graph &g) {
+  // copies the current state of g with the same node ids, without its contraction sequence
+  unsigned int count = 0;
+  n = g.n;
+  m = g.m;
+  twin_width = g.twin_width;
+  unsigned int num_edges = 0;
+  for (node *nd = g.get_first_node(); nd; nd = nd->next) {
+    num_edges += nd->deg;
+  }
+  edges.resize(num_edges);
+  con_seq.reserve(n);
+  adj_list.resize(g.adj_list.size());
+  partition = g.partition;
+  node_mapping = g.node_mapping;
+
+  for (unsigned int source{0}; source < adj_list.size(); ++source) {
+    adj_list[source].id = source;
+    adj_list[source].first = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].last = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].active = g.adj_list[source].active;
+    adj_list[source].deg = g.adj_list[source].deg;
+    adj_list[source].num_red = g.adj_list[source].num_red;
+    adj_list[source].prev = nullptr;
+    adj_list[source].next = nullptr;
+  }
+  // the node list contains the active nodes in order of their id, behind the sentinel 0
+  node *prev = &adj_list[0];
+  for (node *nd = g.get_first_node(); nd; nd = nd->next) {
+    prev->next = &adj_list[nd->id];
+    adj_list[nd->id].prev = prev;
+    prev = &adj_list[nd->id];
+  }
+  adj_list[1].prev = nullptr;
+
+  for (node *nd = g.get_first_node(); nd; nd = nd->next) {
+    unsigned int source = nd->id;
+    for (auto &&e : *nd) {
+      unsigned int target = e.target;
+      if (source >= target) continue;
+      edges[count] = edge{target, e.red};
+      adj_list[source].last->next = &edges[count];
+      edges[count].prev = adj_list[source].last;
+      adj_list[source].last = &edges[count];
+      ++count;
+      edges[count] = edge{source, e.red};
+      adj_list[target].last->next = &edges[count];
+      edges[count].prev = adj_list[target].last;
+      adj_list[target].last = &edges[count];
+      edges[count - 1].other = &edges[count];
+      edges[count].other = &edges[count - 1];
+      ++count;
+    }
+    adj_list[source].last->next = reinterpret_cast<edge *>(&adj_list[source]);
+  }
+}
+
+void graph::read_induced(graph &g, std::vector<unsigned int> &nodes) {
+  // the subgraph of the current state of g induced by nodes, with its red edges, the nodes are numbered from 1 by
+  // increasing id in g, node_mapping maps them back
+  unsigned int count = 0;
+  std::sort(nodes.begin(), nodes.end());
+  std::vector<unsigned int> mapping(g.adj_list.size(), 0);
+  for (unsigned int i = 0; i < nodes.size(); ++i) {
+    mapping[nodes[i]] = i + 1;
+  }
+
+  n = nodes.size();
+  m = 0;
+  for (unsigned int id : nodes) {
+    for (auto &&e : g.adj_list[id]) {
+      if (mapping[e.target]) ++m;
+    }
+  }
+
+  twin_width = 0;
+  edges.resize(m);
+  con_seq.clear();
+  con_seq.reserve(n);
+  adj_list.assign(n + 1, node{});
+  partition.assign(n + 1, 0);
+  node_mapping.resize(n + 1);
+
+  adj_list[0].first = reinterpret_cast<edge *>(&adj_list[0]);
+  adj_list[0].last = reinterpret_cast<edge *>(&adj_list[0]);
+  adj_list[0].active = 0;
+  for (unsigned int source{1}; source <= n; ++source) {
+    node_mapping[source] = nodes[source - 1];
+    adj_list[source].id = source;
+    adj_list[source].first = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].last = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].prev = &adj_list[source - 1];
+    adj_list[source - 1].next = &adj_list[source];
+  }
+  adj_list[1].prev = 0;
+  adj_list[n].next = 0;
+
+  // the adjacency lists of g are sorted, so are the new ones
+  for (unsigned int source{1}; source <= n; ++source) {
+    for (auto &&e : g.adj_list[nodes[source - 1]]) {
+      unsigned int target = mapping[e.target];
+      if (source >= target) continue;
+      edges[count] = edge{target, e.red};
+      adj_list[source].last->next = &edges[count];
+      edges[count].prev = adj_list[source].last;
+      adj_list[source].last = &edges[count];
+      ++count;
+      edges[count] = edge{source, e.red};
+      adj_list[target].last->next = &edges[count];
+      edges[count].prev = adj_list[target].last;
+      adj_list[target].last = &edges[count];
+      edges[count - 1].other = &edges[count];
+      edges[count].other = &edges[count - 1];
+      ++count;
+      ++adj_list[source].deg;
+      ++adj_list[target].deg;
+      if (e.red) {
+        ++adj_list[source].num_red;
+        ++adj_list[target].num_red;
+      }
+    }
+    adj_list[source].last->next = reinterpret_cast<edge *>(&adj_list[source]);
+  }
+  for (unsigned int source{1}; source <= n; ++source) {
+    twin_width = std::max(twin_width, adj_list[source].num_red);
+  }
+}
+
+void graph::write_state(std::ostream &out) {
+  // the current state with the node ids, like copy_from, but for another process
+  out << adj_list.size() << " " << twin_width << " " << n;
+  for (node *nd = get_first_node(); nd; nd = nd->next) {
+    out << " " << nd->id;
+  }
+  out << " " << m / 2;
+  for (node *nd = get_first_node(); nd; nd = nd->next) {
+    for (auto &&e : *nd) {
+      if (nd->id < e.target) out << " " << nd->id << " " << e.target << " " << (int)e.red;
+    }
+  }
+}
+
+void graph::read_state(std::istream &in) {
+  unsigned int size, num_edges;
+  in >> size >> twin_width >> n;
+  std::vector<unsigned int> ids(n);
+  for (auto &&id : ids) {
+    in >> id;
+  }
+  in >> num_edges;
+  m = 2 * num_edges;
+  edges.resize(m);
+  con_seq.clear();
+  con_seq.reserve(n);
+  adj_list.assign(size, node{});
+  partition.assign(size, 0);
+
+  for (unsigned int source{0}; source < size; ++source) {
+    adj_list[source].id = source;
+    adj_list[source].first = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].last = reinterpret_cast<edge *>(&adj_list[source]);
+    adj_list[source].active = 0;
+    adj_list[source].prev = nullptr;
+    adj_list[source].next = nullptr;
+  }
+  node *prev = &adj_list[0];
+  for (unsigned int id : ids) {
+    adj_list[id].active = 1;
+    prev->next = &adj_list[id];
+    adj_list[id].prev = prev;
+    prev = &adj_list[id];
+  }
+  adj_list[1].prev = nullptr;
+
+  // the edges are written by increasing source and target, so every list is sorted
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < num_edges; ++i) {
+    unsigned int source, target, red;
+    in >> source >> target >> red;
+    edges[count] = edge{target, (unsigned char)red};
+    adj_list[source].last->next = &edges[count];
+    edges[count].prev = adj_list[source].last;
+    adj_list[source].last = &edges[count];
+    ++count;
+    edges[count] = edge{source, (unsigned char)red};
+    adj_list[target].last->next = &edges[count];
+    edges[count].prev = adj_list[target].last;
+    adj_list[target].last = &edges[count];
+    edges[count - 1].other = &edges[count];
+    edges[count].other = &edges[count - 1];
+    ++count;
+    ++adj_list[source].deg;
+    ++adj_list[target].deg;
+    adj_list[source].num_red += red;
+    adj_list[target].num_red += red;
+  }
+  for (unsigned int source{0}; source < size; ++source) {
+    adj_list[source].last->next = reinterpret_cast<edge *>(&adj_list[source]);
+  }
+}
+
 void graph::apply_contractions(graph &g) {
   Solution solution = g.build_solution();
   for (auto &c : solution.contractions) {
@@ -592,11 +946,9 @@ void graph::apply_contractions(graph &g) {
 }
 
 bool graph::contractions_independent(std::pair<node *, node *> c1, std::pair<node *, node *> c2) {
-  // c1.first is strictly the smallest id in the contractions
-  assert(c1.first->id > c2.first->id);
   // c2 was already contracted, c2.second is not active
   assert(!c2.second->active);
-  if (c1.second->id == c2.first->id) {
+  if (c1.first->id == c2.first->id || c1.second->id == c2.first->id) {
     return false;
   }
 
@@ -1,8 +1,11 @@
 #ifndef GRAPH_HH_GV0YL8EE
 #define GRAPH_HH_GV0YL8EE
 
+#include <cstdint>
+#include <iostream>
 #include <vector>
 
+#include "bucket_queue.hh"
 #include "solution.hh"
 
 struct edge {
@@ -99,8 +102,14 @@ public:
 
   void contract(unsigned int u, unsigned int v);
   void uncontract(unsigned int steps = 1);
-  bool red_degree_in_limit(node *u, node *v, int limit);
+  bool red_degree_in_limit(node *u, node *v, unsigned int limit);
   bool contractions_independent(std::pair<node *, node *> c1, std::pair<node *, node *> c2);
+  void enable_degree_buckets();
+  void enable_partition_hash();
+  void degree_window(node *u, int limit, std::vector<node *> &candidates, unsigned int after = 0,
+                     bool both_sides = false);
+  void two_hop_candidates(node *u, int limit, std::vector<node *> &candidates);
+  bool has_critical_neighbor(node *u, int limit);
   void read_from_stdin();
   Solution build_solution();
   void print();
@@ -110,6 +119,10 @@ public:
   unsigned int compute_connected_components();
   void read_from_partition(graph &g, unsigned int partition_id);
   void read_complement(graph &g);
+  void copy_from(graph &g);
+  void read_induced(graph &g, std::vector<unsigned int> &nodes);
+  void write_state(std::ostream &out);
+  void read_state(std::istream &in);
   void apply_contractions(graph &g);
 
   graph();
@@ -118,8 +131,20 @@ public:
 
   std::vector<contraction> con_seq;
 
+  // active nodes bucketed by degree, only maintained after enable_degree_buckets()
+  bool degree_buckets_enabled{};
+  bucket_queue degree_buckets;
+  // Zobrist hash of the partition of the nodes at the time of enable_partition_hash(), only maintained afterwards
+  // each part is keyed by the xor of the keys of its nodes, the hash is the xor of the mixed keys of all parts
+  bool partition_hash_enabled{};
+  uint64_t partition_hash{};
+  std::vector<uint64_t> part_keys;
+
 private:
   std::vector<edge> edges;
+  // time stamps for two_hop_candidates
+  std::vector<unsigned int> visited;
+  unsigned int visit_stamp{};
 };
 
 #endif /* end of include guard: GRAPH_HH_GV0YL8EE */
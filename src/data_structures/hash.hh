@@ -0,0 +1,16 @@
+#ifndef HASH_HH
+#define HASH_HH
+
+#include <cstdint>
+
+/**
+ * @brief splitmix64 finalizer, spreads the bits of a key evenly, so xors and prefixes of the mixed keys serve as hashes
+ */
+inline uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+#endif /* end of include guard: HASH_HH */
@@ -0,0 +1,186 @@
+#ifndef MINHASH_HH
+#define MINHASH_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graph.hh"
+#include "hash.hh"
+
+/**
+ * @brief Locality-sensitive hashing of neighborhoods to propose contraction pairs
+ *        nodes with a similar neighborhood (high Jaccard similarity) likely share a bucket in one of the bands,
+ *        the MinHash signature of a band is the minimum of rows hash functions over the neighbors
+ */
+class MinHashIndex {
+public:
+  /**
+   * @param g a graph
+   * @param bands number of bands, two nodes are candidates if their signature is equal in one band
+   * @param rows number of hash functions per band
+   * @param max_candidates maximum number of candidates per node and band
+   */
+  MinHashIndex(graph& g, unsigned int bands = 8, unsigned int rows = 2, unsigned int max_candidates = 16)
+      : g(g), bands(bands), rows(rows), max_candidates(max_candidates) {
+    keys.resize(g.adj_list.size() * bands);
+    positions.resize(g.adj_list.size() * bands);
+    indexed.resize(g.adj_list.size(), false);
+    minima.resize(g.adj_list.size() * bands * rows);
+    buckets.resize(bands);
+    for (unsigned int i = 0; i < bands * rows; ++i) {
+      seeds.push_back(splitmix64(i + 1));
+    }
+    for (node* nd = g.get_first_node(); nd; nd = nd->next) {
+      compute_minima(nd->id);
+      insert(nd->id);
+    }
+  }
+
+  /**
+   * @brief Updates the index after g.contract(u, v)
+   *        only the signatures of u and its neighbors can change, the neighborhood of a neighbor only lost v or had
+   *        v replaced by u, so its minima only have to be recomputed if v was the minimum
+   *
+   * @param changed nodes that moved to a different bucket in at least one band
+   */
+  void contracted(unsigned int u, unsigned int v, std::vector<unsigned int>& changed) {
+    changed.clear();
+    remove(v);
+    compute_minima(u);
+    if (update_keys(u)) changed.push_back(u);
+    for (auto&& e : g.adj_list[u]) {
+      uint64_t* min = &minima[e.target * bands * rows];
+      for (unsigned int i = 0; i < bands * rows; ++i) {
+        if (min[i] == hash(v, i)) {
+          compute_minima(e.target);
+          break;
+        }
+        min[i] = std::min(min[i], hash(u, i));
+      }
+      if (update_keys(e.target)) changed.push_back(e.target);
+    }
+  }
+
+  /**
+   * @brief Nodes sharing a bucket with the given node
+   *
+   * @param id a node
+   * @param candidates at most max_candidates nodes per band, may contain duplicates
+   */
+  void candidates(unsigned int id, std::vector<unsigned int>& candidates) {
+    candidates.clear();
+    for (unsigned int band = 0; band < bands; ++band) {
+      std::vector<unsigned int>& bucket{buckets[band][keys[id * bands + band]]};
+      unsigned int count = 0;
+      for (unsigned int other : bucket) {
+        if (other == id) continue;
+        candidates.push_back(other);
+        if (++count == max_candidates) break;
+      }
+    }
+  }
+
+  /**
+   * @brief Pairs of nodes sharing a bucket, that changed since the last call, at most max_candidates partners per node
+   *        and band, the first call returns the pairs of all buckets
+   *        the pairs of the other buckets were returned before, a bucket only gets new pairs once a node enters it or,
+   *        for the pairs beyond max_candidates, leaves it
+   */
+  void changed_candidates(std::vector<std::pair<unsigned int, unsigned int>>& pairs) {
+    pairs.clear();
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (auto&& [band, key] : touched) {
+      auto it = buckets[band].find(key);
+      if (it == buckets[band].end()) continue;
+      std::vector<unsigned int>& bucket{it->second};
+      for (unsigned int i = 0; i < bucket.size(); ++i) {
+        for (unsigned int j = i + 1; j < bucket.size() && j <= i + max_candidates; ++j) {
+          pairs.push_back({bucket[i], bucket[j]});
+        }
+      }
+    }
+    touched.clear();
+  }
+
+private:
+  graph& g;
+  unsigned int bands;
+  unsigned int rows;
+  unsigned int max_candidates;
+  // seed of each hash function and minimum of each hash function over the neighbors of each node
+  std::vector<uint64_t> seeds;
+  std::vector<uint64_t> minima;
+  // band key and position in its bucket for each node and band
+  std::vector<uint64_t> keys;
+  std::vector<unsigned int> positions;
+  std::vector<bool> indexed;
+  std::vector<std::unordered_map<uint64_t, std::vector<unsigned int>>> buckets;
+  // band and key of the buckets, that changed since the last call of changed_candidates
+  std::vector<std::pair<unsigned int, uint64_t>> touched;
+
+  uint64_t hash(unsigned int id, unsigned int i) { return splitmix64(id ^ seeds[i]); }
+
+  void compute_minima(unsigned int id) {
+    uint64_t* min = &minima[id * bands * rows];
+    std::fill(min, min + bands * rows, UINT64_MAX);
+    for (auto&& e : g.adj_list[id]) {
+      for (unsigned int i = 0; i < bands * rows; ++i) {
+        min[i] = std::min(min[i], hash(e.target, i));
+      }
+    }
+  }
+
+  uint64_t band_key(unsigned int id, unsigned int band) {
+    uint64_t key = band;
+    for (unsigned int row = 0; row < rows; ++row) {
+      key = splitmix64(key ^ minima[(id * bands + band) * rows + row]);
+    }
+    return key;
+  }
+
+  void insert(unsigned int id) {
+    for (unsigned int band = 0; band < bands; ++band) {
+      uint64_t key = band_key(id, band);
+      std::vector<unsigned int>& bucket{buckets[band][key]};
+      keys[id * bands + band] = key;
+      positions[id * bands + band] = bucket.size();
+      bucket.push_back(id);
+      touched.push_back({band, key});
+    }
+    indexed[id] = true;
+  }
+
+  void remove(unsigned int id) {
+    if (!indexed[id]) return;
+    for (unsigned int band = 0; band < bands; ++band) {
+      auto it = buckets[band].find(keys[id * bands + band]);
+      std::vector<unsigned int>& bucket{it->second};
+      unsigned int last = bucket.back();
+      bucket[positions[id * bands + band]] = last;
+      positions[last * bands + band] = positions[id * bands + band];
+      bucket.pop_back();
+      touched.push_back({band, it->first});
+      if (bucket.empty()) buckets[band].erase(it);
+    }
+    indexed[id] = false;
+  }
+
+  // moves the node to the buckets of its current minima, returns if any band changed
+  bool update_keys(unsigned int id) {
+    bool changed = false;
+    for (unsigned int band = 0; band < bands && !changed; ++band) {
+      changed = band_key(id, band) != keys[id * bands + band];
+    }
+    if (changed) {
+      remove(id);
+      insert(id);
+    }
+    return changed;
+  }
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef PAIR_QUEUE_HH
+#define PAIR_QUEUE_HH
+
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "graph.hh"
+#include "pair_scoring.hh"
+
+/**
+ * @brief Priority queue of contraction pairs, that is updated incrementally after each contraction
+ *        for each node the best partner (lowest score, smallest id on ties) is stored, the nodes are ordered by
+ *        (score, id), so the top is the lexicographically smallest pair with the lowest score
+ *        a contraction (u, v) only changes the scores of pairs containing u or one of its neighbors, so only their
+ *        rows and the rows of nodes, whose best partner was one of them, are rescored
+ *
+ * @tparam Score provides static int score(PairScoring& scoring, node* marked, node* other, int cutoff), the symmetric
+ *               score of the pair, exact if it is at most cutoff
+ */
+template <typename Score>
+class PairQueue {
+public:
+  PairQueue(graph& g) : g(g), scoring(g) {
+    unsigned int size = g.adj_list.size();
+    best_score.resize(size, INT_MAX);
+    best_partner.resize(size, NONE);
+    dependents.resize(size);
+    stamps.resize(size, 0);
+    for (node* x = g.get_first_node(); x; x = x->next) {
+      rescan(x);
+    }
+  }
+
+  bool empty() const { return order.empty(); }
+
+  int top_score() const { return order.begin()->first; }
+
+  /**
+   * @brief Lexicographically smallest pair (u, v) with u < v and the lowest score
+   *        the first node with the lowest score has only partners with the same best score, that have a larger id
+   */
+  std::pair<unsigned int, unsigned int> top() const {
+    unsigned int u = order.begin()->second;
+    return {u, best_partner[u]};
+  }
+
+  /**
+   * @brief All pairs (u, v) with u < v and the lowest score, in lexicographic order
+   *        both nodes of such a pair have the lowest score as their best score
+   */
+  void ties(std::vector<std::pair<unsigned int, unsigned int>>& pairs) {
+    pairs.clear();
+    int score = top_score();
+    tied.clear();
+    for (auto it = order.begin(); it != order.end() && it->first == score; ++it) {
+      tied.push_back(&g.adj_list[it->second]);
+    }
+    for (unsigned int i = 0; i < tied.size(); ++i) {
+      scoring.mark(tied[i]);
+      for (unsigned int j = i + 1; j < tied.size(); ++j) {
+        if (Score::score(scoring, tied[i], tied[j], score) == score) pairs.push_back({tied[i]->id, tied[j]->id});
+      }
+    }
+  }
+
+  /**
+   * @brief Updates the queue after g.contract(u, v)
+   */
+  void contracted(unsigned int u, unsigned int v) {
+    if (!g.adj_list[u].active) std::swap(u, v);
+    ++stamp;
+    remove(v);
+
+    // all pairs with u or a neighbor of u may have changed
+    changed.clear();
+    changed.push_back(&g.adj_list[u]);
+    for (auto&& e : g.adj_list[u]) {
+      changed.push_back(&g.adj_list[e.target]);
+    }
+    for (node* c : changed) {
+      stamps[c->id] = stamp;
+    }
+
+    // nodes, whose best partner changed, may now have a worse best score, rescan them completely
+    affected.clear();
+    collect_dependents(v);
+    for (node* c : changed) {
+      collect_dependents(c->id);
+    }
+    for (node* x : affected) {
+      rescan(x);
+    }
+
+    // rescan the changed nodes, their new scores can only improve the best score of unchanged nodes
+    for (node* c : changed) {
+      rescan(c, true);
+    }
+  }
+
+private:
+  static constexpr unsigned int NONE = -1;
+
+  graph& g;
+  PairScoring scoring;
+  // (best score, id) of all nodes with a partner
+  std::set<std::pair<int, unsigned int>> order;
+  std::vector<int> best_score;
+  std::vector<unsigned int> best_partner;
+  // nodes that had the given node as best partner, may contain stale entries
+  std::vector<std::vector<unsigned int>> dependents;
+  // nodes that are already up to date in the current update
+  std::vector<unsigned int> stamps;
+  unsigned int stamp = 0;
+  std::vector<node*> changed;
+  std::vector<node*> affected;
+  std::vector<node*> tied;
+
+  /**
+   * @brief Recomputes the best partner of x
+   *
+   * @param improve_others scores are also used to improve the best partner of nodes not rescanned in this update
+   */
+  void rescan(node* x, bool improve_others = false) {
+    scoring.mark(x);
+    int best = INT_MAX;
+    unsigned int partner = NONE;
+    for (node* w = g.get_first_node(); w; w = w->next) {
+      if (w == x) continue;
+      bool improve = improve_others && stamps[w->id] != stamp;
+      int score = Score::score(scoring, x, w, improve ? std::max(best, best_score[w->id]) : best);
+      if (score < best) {
+        best = score;
+        partner = w->id;
+      }
+      if (improve && (score < best_score[w->id] || (score == best_score[w->id] && x->id < best_partner[w->id]))) {
+        update(w->id, score, x->id);
+      }
+    }
+    update(x->id, best, partner);
+  }
+
+  void update(unsigned int id, int score, unsigned int partner) {
+    if (best_partner[id] != NONE) order.erase({best_score[id], id});
+    best_score[id] = score;
+    best_partner[id] = partner;
+    if (partner == NONE) return;
+    order.insert({score, id});
+
+    std::vector<unsigned int>& list{dependents[partner]};
+    list.push_back(id);
+    // drop stale entries once in a while, so unchanged nodes do not collect them forever
+    if (list.size() >= 16 && !(list.size() & (list.size() - 1))) {
+      std::sort(list.begin(), list.end());
+      list.erase(std::unique(list.begin(), list.end()), list.end());
+      list.erase(std::remove_if(list.begin(), list.end(), [&](unsigned int x) { return best_partner[x] != partner; }),
+                 list.end());
+    }
+  }
+
+  void remove(unsigned int id) {
+    if (best_partner[id] != NONE) order.erase({best_score[id], id});
+    best_score[id] = INT_MAX;
+    best_partner[id] = NONE;
+  }
+
+  void collect_dependents(unsigned int id) {
+    for (unsigned int x : dependents[id]) {
+      if (stamps[x] == stamp || best_partner[x] != id) continue;
+      stamps[x] = stamp;
+      affected.push_back(&g.adj_list[x]);
+    }
+    dependents[id].clear();
+  }
+};
+
+#endif /* end of include guard: PAIR_QUEUE_HH */
@@ -0,0 +1,205 @@
+#ifndef PAIR_SCORING_HH
+#define PAIR_SCORING_HH
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#include "graph.hh"
+
+/**
+ * @brief One-to-many scoring of contraction pairs (u, v)
+ *        the neighborhood of u is marked once in a dense array, afterwards each candidate v is scored by scanning
+ *        only the adjacency list of v
+ */
+class PairScoring {
+public:
+  PairScoring(graph& g) : g(g) { marks.resize(g.adj_list.size(), 0); }
+
+  /**
+   * @brief Marks the neighborhood of u, replacing a previous mark
+   *
+   * @param u the node all following candidates are scored against
+   * @param limit red degree limit used by red_degree_in_limit, neighbors of u that would exceed it are marked critical,
+   *              UINT_MAX for no limit
+   */
+  void mark(node* u, unsigned int limit = UINT_MAX) {
+    unmark();
+    marked = u;
+    num_critical = 0;
+    for (auto&& e : *u) {
+      unsigned char m = NEIGHBOR;
+      if (e.red) m |= RED;
+      if (g.adj_list[e.target].num_red + (e.red ? 0 : 1) > limit) {
+        m |= CRITICAL;
+        ++num_critical;
+      }
+      marks[e.target] = m;
+      marked_ids.push_back(e.target);
+    }
+  }
+
+  void unmark() {
+    // the marked node may have been contracted since, so clear the stored ids instead of its current neighbors
+    for (unsigned int id : marked_ids) {
+      marks[id] = 0;
+    }
+    marked_ids.clear();
+    marked = nullptr;
+  }
+
+  /**
+   * @brief Red degree of the node resulting from contracting the marked node with v
+   *
+   * @param v a node
+   * @param cutoff scoring stops as soon as the red degree is known to exceed the cutoff
+   * @return unsigned int the red degree, or a lower bound of it that is greater than cutoff
+   */
+  unsigned int red_degree(node* v, unsigned int cutoff = UINT_MAX) {
+    node* u = marked;
+    unsigned int uv_red = (marks[v->id] & RED) ? 1 : 0;
+    unsigned int lower = red_degree_lower_bound(u, v, uv_red);
+    if (lower > cutoff) return lower;
+
+    // red neighbors of u stay red
+    unsigned int red_deg = u->num_red - uv_red;
+    unsigned int common_black = 0;
+    for (auto&& e : *v) {
+      if (e.target == u->id) continue;
+      if (!marks[e.target]) {
+        ++red_deg;
+      } else if (!(marks[e.target] & RED)) {
+        ++common_black;
+        if (e.red) ++red_deg;
+      }
+      if (red_deg > cutoff) return red_deg;
+    }
+    // black neighbors of u, that are not shared with v
+    return red_deg + black_degree(u, v, uv_red) - common_black;
+  }
+
+  /**
+   * @brief Size of the symmetric difference of both neighborhoods minus the common red neighbors of the marked node
+   *
+   * @param v a node
+   * @param cutoff scoring stops as soon as the delta is known to exceed the cutoff
+   * @param v_first the common red neighbors of v are subtracted instead, i.e. the delta of the pair (v, marked)
+   * @return int the delta, or a lower bound of it that is greater than cutoff
+   */
+  int red_degree_delta(node* v, int cutoff = INT_MAX, bool v_first = false) {
+    int u_deg = marked->deg;
+    int v_deg = v->deg;
+    int u_red = v_first ? v->num_red : marked->num_red;
+    // at most min(deg(u), deg(v)) common neighbors, each lowering the delta by at most 3
+    int possible = std::min(u_deg, v_deg);
+    int lower = u_deg + v_deg - 2 * possible - std::min(possible, u_red);
+    if (lower > cutoff) return lower;
+
+    int common = 0;
+    int common_red = 0;
+    int remaining = v_deg;
+    for (auto&& e : *v) {
+      --remaining;
+      if (marks[e.target]) {
+        ++common;
+        if (v_first ? e.red : (marks[e.target] & RED)) ++common_red;
+      } else {
+        possible = std::min(remaining, u_deg - common);
+        lower = u_deg + v_deg - 2 * (common + possible) - common_red - std::min(possible, u_red - common_red);
+        if (lower > cutoff) return lower;
+      }
+    }
+    return u_deg + v_deg - 2 * common - common_red;
+  }
+
+  /**
+   * @brief Equivalent of graph::red_degree_in_limit for the marked node and v
+   *        the marked node has to be marked with the same limit
+   */
+  bool red_degree_in_limit(node* v, unsigned int limit) {
+    node* u = marked;
+    unsigned int uv_red = (marks[v->id] & RED) ? 1 : 0;
+    if (red_degree_lower_bound(u, v, uv_red) > limit) return false;
+
+    unsigned int red_deg = u->num_red - uv_red;
+    unsigned int common_black = 0;
+    unsigned int common_critical = 0;
+    for (auto&& e : *v) {
+      if (e.target == u->id) continue;
+      if (marks[e.target]) {
+        if (marks[e.target] & CRITICAL) ++common_critical;
+        if (!(marks[e.target] & RED)) {
+          ++common_black;
+          if (e.red) ++red_deg;
+        }
+      } else {
+        ++red_deg;
+        if (g.adj_list[e.target].num_red + (e.red ? 0 : 1) > limit) return false;
+      }
+      if (red_deg > limit) return false;
+    }
+    // critical neighbors of u, that are not shared with v, get a red degree above the limit
+    if (num_critical > common_critical + ((marks[v->id] & CRITICAL) ? 1 : 0)) return false;
+
+    return red_deg + black_degree(u, v, uv_red) - common_black <= limit;
+  }
+
+  /**
+   * @brief Scores u against all nodes after u in the node list
+   *
+   * @param u a node
+   * @param scores resulting red degree for each following node, in node list order
+   * @param cutoff scores greater than the cutoff or the best score of the row so far are only lower bounds
+   */
+  void red_degrees(node* u, std::vector<unsigned int>& scores, unsigned int cutoff = UINT_MAX) {
+    mark(u);
+    scores.clear();
+    for (node* v = u->next; v; v = v->next) {
+      scores.push_back(red_degree(v, cutoff));
+      cutoff = std::min(cutoff, scores.back());
+    }
+  }
+
+  /**
+   * @brief Scores u against all nodes after u in the node list
+   *
+   * @param u a node
+   * @param scores resulting red degree delta for each following node, in node list order
+   * @param cutoff scores greater than the cutoff or the best score of the row so far are only lower bounds
+   */
+  void red_degree_deltas(node* u, std::vector<int>& scores, int cutoff = INT_MAX) {
+    mark(u);
+    scores.clear();
+    for (node* v = u->next; v; v = v->next) {
+      scores.push_back(red_degree_delta(v, cutoff));
+      cutoff = std::min(cutoff, scores.back());
+    }
+  }
+
+private:
+  static constexpr unsigned char NEIGHBOR = 1;
+  static constexpr unsigned char RED = 2;
+  static constexpr unsigned char CRITICAL = 4;
+
+  graph& g;
+  std::vector<unsigned char> marks;
+  std::vector<unsigned int> marked_ids;
+  node* marked = nullptr;
+  unsigned int num_critical = 0;
+
+  /**
+   * @brief Lower bound on the red degree after contracting u and v, that needs no list traversal
+   *        all red neighbors of one node stay red and the surplus neighbors of the other node become red
+   */
+  static unsigned int red_degree_lower_bound(node* u, node* v, unsigned int uv_red) {
+    if (v->deg > u->deg) return u->num_red - uv_red + v->deg - u->deg;
+    return v->num_red - uv_red + u->deg - v->deg;
+  }
+
+  // number of black neighbors of the marked node u, excluding v
+  unsigned int black_degree(node* u, node* v, unsigned int uv_red) {
+    return u->deg - (marks[v->id] ? 1 : 0) - (u->num_red - uv_red);
+  }
+};
+
+#endif
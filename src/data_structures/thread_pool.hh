@@ -0,0 +1,93 @@
+#ifndef THREAD_POOL_HH
+#define THREAD_POOL_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of threads for data parallel loops
+ *        the calling thread takes part in each loop as thread 0, so a pool of size 1 has no extra threads
+ */
+class ThreadPool {
+public:
+  ThreadPool(unsigned int size) : num_threads(size) {
+    for (unsigned int t = 1; t < size; ++t) {
+      threads.emplace_back([this, t]() { run(t); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      shutdown = true;
+    }
+    start.notify_all();
+    for (auto&& thread : threads) {
+      thread.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+
+  unsigned int size() const { return num_threads; }
+
+  /**
+   * @brief Calls fn(thread, i) for all i in [0, n) and waits until all calls returned
+   *        indices are handed out dynamically, fn must only write data owned by the thread or the index
+   */
+  void parallel_for(unsigned int n, const std::function<void(unsigned int, unsigned int)>& fn) {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      job = &fn;
+      job_size = n;
+      next = 0;
+      running = num_threads - 1;
+      ++generation;
+    }
+    start.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock{mutex};
+    done.wait(lock, [&]() { return !running; });
+    job = nullptr;
+  }
+
+private:
+  unsigned int num_threads;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+  const std::function<void(unsigned int, unsigned int)>* job = nullptr;
+  unsigned int job_size = 0;
+  std::atomic<unsigned int> next{0};
+  unsigned int running = 0;
+  unsigned int generation = 0;
+  bool shutdown = false;
+
+  void work(unsigned int t) {
+    for (unsigned int i = next++; i < job_size; i = next++) {
+      (*job)(t, i);
+    }
+  }
+
+  void run(unsigned int t) {
+    unsigned int seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        start.wait(lock, [&]() { return shutdown || generation != seen; });
+        if (shutdown) return;
+        seen = generation;
+      }
+      work(t);
+      std::lock_guard<std::mutex> lock{mutex};
+      if (!--running) done.notify_one();
+    }
+  }
+};
+
+#endif /* end of include guard: THREAD_POOL_HH */
@@ -0,0 +1,64 @@
+#ifndef TRANSPOSITION_TABLE_HH
+#define TRANSPOSITION_TABLE_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Bounded table of search states, that were already explored
+ *        a state is stored with the lowest twin width it was reached with, a new entry replaces the one in its slot
+ *        the entries are tagged with a generation, so a table is reused by later searches without clearing its slots
+ */
+class TranspositionTable {
+public:
+  /**
+   * @param bits the table has 2^bits slots
+   */
+  TranspositionTable(unsigned int bits = 20) : mask((uint64_t{1} << bits) - 1) { entries.resize(mask + 1); }
+
+  /**
+   * @brief Forgets all states, the slots are only reset, once the generations wrap around
+   */
+  void clear() {
+    hits = 0;
+    if (++generation) return;
+    std::fill(entries.begin(), entries.end(), entry{});
+    generation = 1;
+  }
+
+  /**
+   * @brief Records a state, unless it was already explored with at most the same twin width
+   *
+   * @param key hash of the state
+   * @param twin_width twin width of the contraction sequence leading to the state
+   * @return bool if the state has to be explored
+   */
+  bool visit(uint64_t key, unsigned int twin_width) {
+    entry& e{entries[key & mask]};
+    if (e.generation == generation && e.key == key && e.twin_width <= twin_width) {
+      ++hits;
+      return false;
+    }
+    e.key = key;
+    e.twin_width = twin_width;
+    e.generation = generation;
+    return true;
+  }
+
+  unsigned long long hits = 0;
+
+private:
+  struct entry {
+    uint64_t key{};
+    unsigned int twin_width{};
+    // 0 marks an empty slot
+    unsigned int generation{};
+  };
+
+  uint64_t mask;
+  unsigned int generation = 1;
+  std::vector<entry> entries;
+};
+
+#endif /* end of include guard: TRANSPOSITION_TABLE_HH */
@@ -15,22 +15,34 @@ public:
 
   /**
    * @brief Applies the degree one reduction to a given graph
+   *        two leaves of the same neighbor are contracted whatever the colors of their edges, the merged edge is only
+   *        red if one of them was, so no red degree grows and the leaves are found by degree alone
    *
    * @param g a graph
    */
   static void reduce(graph& g) {
-    // one deg one neighbor for each node
+    g.enable_degree_buckets();
     std::vector<unsigned int> deg_one_neighbors;
-    deg_one_neighbors.resize(g.adj_list.size(), 0);
-
-    for (node* nd = g.get_first_node(); nd; nd = nd->next) {
-      if (nd->deg == 1) {
-        unsigned int target = nd->first->target;
-        if (deg_one_neighbors[target]) {
-          g.contract(nd->id, deg_one_neighbors[target]);
-          deg_one_neighbors[target] = std::min(nd->id, deg_one_neighbors[target]);
-        } else {
-          deg_one_neighbors[target] = nd->id;
+    std::vector<unsigned int> leaves;
+    // contracting two leaves can turn their neighbor into a new leaf, so the leaves are scanned until none is left
+    for (bool changed = true; changed;) {
+      changed = false;
+      // one deg one neighbor for each node
+      deg_one_neighbors.assign(g.adj_list.size(), 0);
+      leaves = g.degree_buckets.bucket(1);
+      std::sort(leaves.begin(), leaves.end());
+      for (unsigned int id : leaves) {
+        node* nd = &g.adj_list[id];
+        if (nd->active && nd->deg == 1) {
+          unsigned int target = nd->first->target;
+          if (deg_one_neighbors[target]) {
+            // the contraction keeps nd
+            g.contract(nd->id, deg_one_neighbors[target]);
+            deg_one_neighbors[target] = nd->id;
+            changed = true;
+          } else {
+            deg_one_neighbors[target] = nd->id;
+          }
         }
       }
     }
@@ -20,14 +20,13 @@ public:
    * @return int the id of the remaining node of degree zero, or 0
    */
   static int reduce(graph& g) {
-    int z = 0;
-    for (node* current_node = g.get_first_node(); current_node; current_node = current_node->next) {
-      if (current_node->deg) continue;
-      if (z) {
-        g.contract(z, current_node->id);
-      } else {
-        z = current_node->id;
-      }
+    g.enable_degree_buckets();
+    // contracting isolated nodes keeps them in the bucket of degree zero
+    std::vector<unsigned int> isolated{g.degree_buckets.bucket(0)};
+    if (isolated.empty()) return 0;
+    unsigned int z = *std::min_element(isolated.begin(), isolated.end());
+    for (unsigned int id : isolated) {
+      if (id != z) g.contract(z, id);
     }
     return z;
   }
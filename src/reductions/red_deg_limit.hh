@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "../data_structures/graph.hh"
+#include "../data_structures/pair_scoring.hh"
 
 class RedDegLimitReduction {
 public:
@@ -15,6 +16,8 @@ public:
 
   /**
    * @brief Contracts all node pairs, that do not lead to a red degree higher than the limit
+   *        after the first sweep over all pairs, only pairs with a node, that was affected by a contraction since it
+   *        was last checked, are checked again, all other pairs still exceed the limit
    *
    * @param g a graph
    */
@@ -23,19 +26,79 @@ public:
     // default: current twin width
     if (limit == 0) limit = g.twin_width;
 
-    unsigned int old_n = 0;
-    do {
-      old_n = g.n;
-      for (node* u = g.get_first_node(); u; u = u->next) {
-        for (node* v = u->next; v; v = v->next) {
-          if (g.red_degree_in_limit(u, v, limit)) {
-            g.contract(u->id, v->id);
-            --node_limit;
-            if (!node_limit) return;
-          }
+    g.enable_degree_buckets();
+    PairScoring scoring{g};
+    std::vector<node*> candidates;
+    std::deque<unsigned int> worklist;
+    std::vector<bool> dirty(g.adj_list.size(), false);
+    std::vector<unsigned int> red_marks(g.adj_list.size(), 0);
+    std::vector<unsigned int> fewer_red;
+    unsigned int stamp = 0;
+
+    auto contract = [&](node* u, node* v) {
+      // common red neighbors lose a red edge, this may bring pairs of their neighbors into the limit
+      ++stamp;
+      for (auto&& e : *u) {
+        if (e.red) red_marks[e.target] = stamp;
+      }
+      fewer_red.clear();
+      for (auto&& e : *v) {
+        if (e.red && red_marks[e.target] == stamp) fewer_red.push_back(e.target);
+      }
+      g.contract(u->id, v->id);
+      --node_limit;
+      if (!exhaustively) return;
+
+      node* w = u->active ? u : v;
+      auto touch = [&](unsigned int id) {
+        if (dirty[id]) return;
+        dirty[id] = true;
+        worklist.push_back(id);
+      };
+      touch(w->id);
+      for (auto&& e : *w) {
+        touch(e.target);
+      }
+      for (unsigned int id : fewer_red) {
+        for (auto&& e : g.adj_list[id]) {
+          touch(e.target);
+        }
+      }
+    };
+
+    for (node* u = g.get_first_node(); u; u = u->next) {
+      scoring.mark(u, limit);
+      g.degree_window(u, limit, candidates);
+      unsigned int i = 0;
+      while (i < candidates.size()) {
+        node* v = candidates[i++];
+        if (scoring.red_degree_in_limit(v, limit)) {
+          contract(u, v);
+          if (!node_limit) return;
+          // neighborhood and degree of u changed
+          scoring.mark(u, limit);
+          g.degree_window(u, limit, candidates, v->id);
+          i = 0;
+        }
+      }
+    }
+
+    while (!worklist.empty()) {
+      node* u = &g.adj_list[worklist.front()];
+      worklist.pop_front();
+      dirty[u->id] = false;
+      if (!u->active) continue;
+      scoring.mark(u, limit);
+      g.degree_window(u, limit, candidates, 0, true);
+      for (node* v : candidates) {
+        if (scoring.red_degree_in_limit(v, limit)) {
+          // the remaining node is queued again
+          contract(u->id < v->id ? u : v, u->id < v->id ? v : u);
+          if (!node_limit) return;
+          break;
         }
       }
-    } while (exhaustively && old_n != g.n);
+    }
   }
 };
 
@@ -28,11 +28,14 @@ public:
     if (limit == 0) limit = g.twin_width;
 
     std::vector<std::pair<node*, node*>> candidates;
+    std::vector<node*> window;
 
+    g.enable_degree_buckets();
     unsigned int old_n = 0;
     do {
       for (node* u = g.get_first_node(); u; u = u->next) {
-        for (node* v = u->next; v; v = v->next) {
+        g.degree_window(u, limit, window);
+        for (node* v : window) {
           if (g.red_degree_in_limit(u, v, limit)) {
             candidates.push_back({u, v});
             // g.contract(u->id, v->id);
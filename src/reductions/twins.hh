@@ -68,7 +68,60 @@ public:
     }
   }
 
+  /**
+   * @brief Finds a contraction, that the twin, degree zero or degree one reduction would apply, involving u or one of
+   *        its neighbors
+   *        after a contraction into u, only u and its neighbors have a different neighborhood, so only they can have
+   *        become twins or degree one nodes sharing their neighbor
+   *
+   * @param g a graph with degree buckets
+   * @param u a node
+   * @param x first node of the contraction
+   * @param y second node of the contraction
+   * @return bool if a contraction was found
+   */
+  static bool find_near(graph &g, node *u, unsigned int &x, unsigned int &y) {
+    if (find_partner(g, u, x, y)) return true;
+    for (auto &&e : *u) {
+      if (find_partner(g, &g.adj_list[e.target], x, y)) return true;
+    }
+    return false;
+  }
+
 private:
+  static bool find_partner(graph &g, node *u, unsigned int &x, unsigned int &y) {
+    x = u->id;
+    if (!u->deg) {
+      // degree zero nodes are twins
+      for (unsigned int id : g.degree_buckets.bucket(0)) {
+        if (id == u->id) continue;
+        y = id;
+        return true;
+      }
+      return false;
+    }
+    // a twin is adjacent to all neighbors of u except itself, so it is the neighbor of smallest degree or one of its
+    // neighbors
+    node *t = nullptr;
+    for (auto &&e : *u) {
+      if (!t || g.adj_list[e.target].deg < t->deg) t = &g.adj_list[e.target];
+    }
+    if (t->deg == u->deg && are_twins(u, t, g)) {
+      y = t->id;
+      return true;
+    }
+    for (auto &&e : *t) {
+      node *v = &g.adj_list[e.target];
+      if (v == u || v->deg != u->deg) continue;
+      // degree one nodes with the same neighbor are contracted regardless of the edge colors
+      if (u->deg == 1 || are_twins(u, v, g)) {
+        y = v->id;
+        return true;
+      }
+    }
+    return false;
+  }
+
   static bool are_twins(node *u, node *v, const graph &g) {
     edge *u_ptr{u->first};
     edge *v_ptr{v->first};
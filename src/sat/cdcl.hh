@@ -0,0 +1,471 @@
+#ifndef CDCL_HH
+#define CDCL_HH
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Small incremental CDCL SAT solver
+ *        two watched literals, first UIP learning with clause minimization, VSIDS with phase saving, Luby restarts
+ *        and a learnt clause database reduced by activity
+ *        clauses can be added between solves, learnt clauses are implied by the clauses, so they are kept, a solve
+ *        under assumptions decides them first, which makes selector literals switch constraints on and off
+ */
+class CDCL {
+public:
+  using Lit = int;
+  enum Result { SATISFIABLE, UNSATISFIABLE, UNKNOWN };
+
+  static Lit pos(int var) { return 2 * var; }
+  static Lit neg(int var) { return 2 * var + 1; }
+
+  int new_var() {
+    int var = assigns.size();
+    assigns.push_back(UNDEF);
+    level.push_back(0);
+    reason.push_back(NO_REASON);
+    activity.push_back(0);
+    polarity.push_back(1);
+    seen.push_back(0);
+    heap_index.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    heap_insert(var);
+    return var;
+  }
+
+  int num_vars() const { return assigns.size(); }
+
+  /**
+   * @brief Makes the search decide a variable before the variables with a lower priority, until conflicts bump them
+   *
+   * @param phase value the variable is decided to first
+   */
+  void set_priority(int var, double priority, bool phase) {
+    activity[var] = priority;
+    polarity[var] = !phase;
+    if (heap_index[var] >= 0) heap_up(heap_index[var]);
+  }
+
+  /**
+   * @brief Adds a clause, only between solves
+   *
+   * @return bool false, if the clauses are unsatisfiable at the root already
+   */
+  bool add_clause(std::vector<Lit> lits) {
+    if (!ok) return false;
+    std::sort(lits.begin(), lits.end());
+    std::vector<Lit> kept;
+    for (size_t i = 0; i < lits.size(); ++i) {
+      // a clause with both literals of a variable is always satisfied
+      if (value(lits[i]) == TRUE || (i + 1 < lits.size() && lits[i + 1] == (lits[i] ^ 1))) return true;
+      if (value(lits[i]) == UNDEF && (kept.empty() || kept.back() != lits[i])) kept.push_back(lits[i]);
+    }
+    if (kept.empty()) return ok = false;
+    if (kept.size() == 1) {
+      enqueue(kept[0], NO_REASON);
+      return ok = propagate() == NO_REASON;
+    }
+    attach(store(std::move(kept), false));
+    return true;
+  }
+
+  /**
+   * @brief Searches for a model, in which all assumptions are true
+   *
+   * @param conflict_limit conflicts until the search gives up, negative for no limit
+   * @param interrupted checked from time to time, the search gives up, once it returns true
+   * @return Result UNSATISFIABLE, if there is no model with the assumptions
+   */
+  template <typename Interrupted>
+  Result solve(const std::vector<Lit> &assumptions, long long conflict_limit, Interrupted interrupted) {
+    if (!ok) return UNSATISFIABLE;
+    long long budget_end = conflict_limit < 0 ? -1 : conflicts + conflict_limit;
+    Result result = UNKNOWN;
+    for (int restart = 0; result == UNKNOWN; ++restart) {
+      long long restart_conflicts = 100 * luby(restart);
+      result = search(assumptions, restart_conflicts, budget_end, interrupted);
+      if (result == UNKNOWN && ((budget_end >= 0 && conflicts >= budget_end) || interrupted())) break;
+    }
+    if (result == SATISFIABLE) {
+      model.assign(assigns.begin(), assigns.end());
+    }
+    cancel_until(0);
+    return result;
+  }
+
+  /**
+   * @brief Value of a variable in the model of the last satisfiable solve
+   */
+  bool model_value(int var) const { return model[var] == TRUE; }
+
+  long long conflicts = 0;
+
+private:
+  static constexpr int8_t TRUE = 1, FALSE = -1, UNDEF = 0;
+  static constexpr int NO_REASON = -1;
+
+  struct Clause {
+    std::vector<Lit> lits;
+    bool learnt;
+    bool deleted = false;
+    double activity = 0;
+  };
+
+  struct Watcher {
+    int clause;
+    Lit blocker;
+  };
+
+  bool ok = true;
+  std::vector<int8_t> assigns;
+  std::vector<int8_t> model;
+  std::vector<int> level;
+  std::vector<int> reason;
+  std::vector<double> activity;
+  std::vector<int8_t> polarity;
+  std::vector<int8_t> seen;
+  std::vector<std::vector<Watcher>> watches;
+  std::vector<Clause> clauses;
+  std::vector<int> free_clauses;
+  std::vector<int> learnts;
+  std::vector<Lit> trail;
+  std::vector<int> trail_lim;
+  size_t qhead = 0;
+  double var_inc = 1, clause_inc = 1;
+  double max_learnts = 0;
+  // binary max heap of the variables by activity
+  std::vector<int> heap;
+  std::vector<int> heap_index;
+
+  int8_t value(Lit lit) const {
+    int8_t v = assigns[lit >> 1];
+    return lit & 1 ? -v : v;
+  }
+
+  int decision_level() const { return trail_lim.size(); }
+
+  static long long luby(int i) {
+    // i-th element of 1, 1, 2, 1, 1, 2, 4, 1, ...
+    long long size = 1, seq = 0;
+    while (size < i + 1) {
+      ++seq;
+      size = 2 * size + 1;
+    }
+    while (size - 1 != i) {
+      size = (size - 1) >> 1;
+      --seq;
+      i = i % size;
+    }
+    return 1LL << seq;
+  }
+
+  int store(std::vector<Lit> &&lits, bool learnt) {
+    int index;
+    if (free_clauses.empty()) {
+      index = clauses.size();
+      clauses.push_back({std::move(lits), learnt});
+    } else {
+      index = free_clauses.back();
+      free_clauses.pop_back();
+      clauses[index] = {std::move(lits), learnt};
+    }
+    return index;
+  }
+
+  void attach(int index) {
+    Clause &c = clauses[index];
+    watches[c.lits[0]].push_back({index, c.lits[1]});
+    watches[c.lits[1]].push_back({index, c.lits[0]});
+  }
+
+  void enqueue(Lit lit, int from) {
+    int var = lit >> 1;
+    assigns[var] = lit & 1 ? FALSE : TRUE;
+    level[var] = decision_level();
+    reason[var] = from;
+    trail.push_back(lit);
+  }
+
+  /**
+   * @brief Propagates the trail, the watches of a clause are its first two literals, an implied literal is first
+   *
+   * @return int conflicting clause or NO_REASON
+   */
+  int propagate() {
+    int conflict = NO_REASON;
+    while (qhead < trail.size() && conflict == NO_REASON) {
+      Lit false_lit = trail[qhead++] ^ 1;
+      std::vector<Watcher> &ws = watches[false_lit];
+      size_t i = 0, j = 0;
+      while (i < ws.size()) {
+        Watcher w = ws[i++];
+        if (clauses[w.clause].deleted) continue;
+        if (value(w.blocker) == TRUE) {
+          ws[j++] = w;
+          continue;
+        }
+        std::vector<Lit> &lits = clauses[w.clause].lits;
+        if (lits[0] == false_lit) std::swap(lits[0], lits[1]);
+        Lit first = lits[0];
+        if (first != w.blocker && value(first) == TRUE) {
+          ws[j++] = {w.clause, first};
+          continue;
+        }
+        bool moved = false;
+        for (size_t k = 2; k < lits.size(); ++k) {
+          if (value(lits[k]) != FALSE) {
+            std::swap(lits[1], lits[k]);
+            watches[lits[1]].push_back({w.clause, first});
+            moved = true;
+            break;
+          }
+        }
+        if (moved) continue;
+        ws[j++] = {w.clause, first};
+        if (value(first) == FALSE) {
+          conflict = w.clause;
+          while (i < ws.size()) ws[j++] = ws[i++];
+        } else {
+          enqueue(first, w.clause);
+        }
+      }
+      ws.resize(j);
+    }
+    return conflict;
+  }
+
+  void cancel_until(int target) {
+    if (decision_level() <= target) return;
+    for (size_t i = trail.size(); i-- > (size_t)trail_lim[target];) {
+      int var = trail[i] >> 1;
+      polarity[var] = trail[i] & 1;
+      assigns[var] = UNDEF;
+      reason[var] = NO_REASON;
+      if (heap_index[var] < 0) heap_insert(var);
+    }
+    trail.resize(trail_lim[target]);
+    trail_lim.resize(target);
+    qhead = trail.size();
+  }
+
+  /**
+   * @brief First UIP conflict analysis
+   *
+   * @param learnt learnt clause, its first literal is asserting, its second has the backtrack level
+   * @return int backtrack level
+   */
+  int analyze(int conflict, std::vector<Lit> &learnt) {
+    learnt.assign(1, 0);
+    int open = 0;
+    Lit p = -1;
+    size_t index = trail.size();
+    do {
+      Clause &c = clauses[conflict];
+      if (c.learnt) bump_clause(c);
+      for (size_t i = p == -1 ? 0 : 1; i < c.lits.size(); ++i) {
+        Lit q = c.lits[i];
+        int var = q >> 1;
+        if (!seen[var] && level[var] > 0) {
+          bump_var(var);
+          seen[var] = 1;
+          if (level[var] >= decision_level()) {
+            ++open;
+          } else {
+            learnt.push_back(q);
+          }
+        }
+      }
+      while (!seen[trail[--index] >> 1]) {
+      }
+      p = trail[index];
+      conflict = reason[p >> 1];
+      seen[p >> 1] = 0;
+      --open;
+    } while (open > 0);
+    learnt[0] = p ^ 1;
+
+    // a literal implied by other literals of the clause is redundant
+    std::vector<Lit> analyzed(learnt.begin() + 1, learnt.end());
+    size_t kept = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+      int from = reason[learnt[i] >> 1];
+      bool redundant = from != NO_REASON;
+      if (redundant) {
+        std::vector<Lit> &lits = clauses[from].lits;
+        for (size_t k = 1; k < lits.size() && redundant; ++k) {
+          int var = lits[k] >> 1;
+          redundant = seen[var] || level[var] == 0;
+        }
+      }
+      if (!redundant) learnt[kept++] = learnt[i];
+    }
+    learnt.resize(kept);
+    for (Lit lit : analyzed) seen[lit >> 1] = 0;
+
+    int backtrack = 0;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+      if (level[learnt[i] >> 1] > backtrack) {
+        backtrack = level[learnt[i] >> 1];
+        std::swap(learnt[1], learnt[i]);
+      }
+    }
+    return backtrack;
+  }
+
+  template <typename Interrupted>
+  Result search(const std::vector<Lit> &assumptions, long long restart_conflicts, long long budget_end,
+                Interrupted interrupted) {
+    std::vector<Lit> learnt;
+    long long restart_end = conflicts + restart_conflicts;
+    while (true) {
+      int conflict = propagate();
+      if (conflict != NO_REASON) {
+        ++conflicts;
+        if (decision_level() == 0) {
+          ok = false;
+          return UNSATISFIABLE;
+        }
+        int backtrack = analyze(conflict, learnt);
+        cancel_until(backtrack);
+        if (learnt.size() == 1) {
+          enqueue(learnt[0], NO_REASON);
+        } else {
+          int index = store(std::vector<Lit>(learnt), true);
+          learnts.push_back(index);
+          attach(index);
+          bump_clause(clauses[index]);
+          enqueue(learnt[0], index);
+        }
+        var_inc /= 0.95;
+        clause_inc /= 0.999;
+        continue;
+      }
+      if (conflicts >= restart_end || (budget_end >= 0 && conflicts >= budget_end) ||
+          ((conflicts & 255) == 0 && conflicts && interrupted())) {
+        cancel_until(0);
+        return UNKNOWN;
+      }
+      if (decision_level() == 0 && max_learnts == 0) {
+        max_learnts = std::max<double>(clauses.size() / 3.0, 5000);
+      }
+      if (learnts.size() >= max_learnts + trail.size()) {
+        reduce_learnts();
+      }
+      Lit next = -1;
+      while (decision_level() < (int)assumptions.size()) {
+        Lit a = assumptions[decision_level()];
+        if (value(a) == TRUE) {
+          // the assumption holds already, an empty level keeps the levels aligned with the assumptions
+          trail_lim.push_back(trail.size());
+        } else if (value(a) == FALSE) {
+          cancel_until(0);
+          return UNSATISFIABLE;
+        } else {
+          next = a;
+          break;
+        }
+      }
+      if (next == -1) {
+        int var = -1;
+        while (!heap.empty()) {
+          var = heap_pop();
+          if (assigns[var] == UNDEF) break;
+          var = -1;
+        }
+        if (var == -1) return SATISFIABLE;
+        next = 2 * var + polarity[var];
+      }
+      trail_lim.push_back(trail.size());
+      enqueue(next, NO_REASON);
+    }
+  }
+
+  void reduce_learnts() {
+    std::sort(learnts.begin(), learnts.end(),
+              [&](int a, int b) { return clauses[a].activity < clauses[b].activity; });
+    size_t kept = 0;
+    for (size_t i = 0; i < learnts.size(); ++i) {
+      Clause &c = clauses[learnts[i]];
+      bool locked = reason[c.lits[0] >> 1] == learnts[i] && value(c.lits[0]) == TRUE;
+      if (i < learnts.size() / 2 && !locked && c.lits.size() > 2) {
+        c.deleted = true;
+      } else {
+        learnts[kept++] = learnts[i];
+      }
+    }
+    learnts.resize(kept);
+    for (auto &&ws : watches) {
+      ws.erase(std::remove_if(ws.begin(), ws.end(), [&](const Watcher &w) { return clauses[w.clause].deleted; }),
+               ws.end());
+    }
+    for (size_t i = 0; i < clauses.size(); ++i) {
+      if (clauses[i].deleted && !clauses[i].lits.empty()) {
+        clauses[i].lits = {};
+        free_clauses.push_back(i);
+      }
+    }
+    max_learnts *= 1.1;
+  }
+
+  void bump_var(int var) {
+    if ((activity[var] += var_inc) > 1e100) {
+      for (double &a : activity) a *= 1e-100;
+      var_inc *= 1e-100;
+    }
+    if (heap_index[var] >= 0) heap_up(heap_index[var]);
+  }
+
+  void bump_clause(Clause &c) {
+    if ((c.activity += clause_inc) > 1e20) {
+      for (int index : learnts) clauses[index].activity *= 1e-20;
+      clause_inc *= 1e-20;
+    }
+  }
+
+  void heap_insert(int var) {
+    heap_index[var] = heap.size();
+    heap.push_back(var);
+    heap_up(heap.size() - 1);
+  }
+
+  int heap_pop() {
+    int top = heap[0];
+    heap_index[top] = -1;
+    heap[0] = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+      heap_index[heap[0]] = 0;
+      heap_down(0);
+    }
+    return top;
+  }
+
+  void heap_up(size_t i) {
+    int var = heap[i];
+    while (i > 0 && activity[heap[(i - 1) / 2]] < activity[var]) {
+      heap[i] = heap[(i - 1) / 2];
+      heap_index[heap[i]] = i;
+      i = (i - 1) / 2;
+    }
+    heap[i] = var;
+    heap_index[var] = i;
+  }
+
+  void heap_down(size_t i) {
+    int var = heap[i];
+    while (2 * i + 1 < heap.size()) {
+      size_t child = 2 * i + 1;
+      if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) ++child;
+      if (activity[heap[child]] <= activity[var]) break;
+      heap[i] = heap[child];
+      heap_index[heap[i]] = i;
+      i = child;
+    }
+    heap[i] = var;
+    heap_index[var] = i;
+  }
+};
+
+#endif /* end of include guard: CDCL_HH */
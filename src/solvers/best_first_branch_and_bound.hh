@@ -0,0 +1,188 @@
+#ifndef BEST_FIRST_BRANCH_AND_BOUND_HH
+#define BEST_FIRST_BRANCH_AND_BOUND_HH
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/checkpoint.hh"
+#include "../data_structures/contraction_enumeration.hh"
+#include "../data_structures/graph.hh"
+#include "../data_structures/transposition_table.hh"
+#include "../reductions/twins.hh"
+#include "../utils.hh"
+#include "cycle_detection.hh"
+
+/**
+ * @brief Branch and bound, that expands the state with the lowest lower bound first
+ *        the bound of a state is its lookahead bound (see ContractionEnumeration::lookahead_bound), so the lowest
+ *        bound of the frontier is a lower bound of the whole search, which is optimal, once it reaches the incumbent
+ *        the frontier holds the states as subtrees of the enumeration (see SearchTask), once it needs more memory than
+ *        allowed, its subtrees are searched depth-first, still by increasing bound
+ */
+class BestFirstBranchAndBound {
+public:
+  /**
+   * @brief Searches for a contraction sequence with a tww lower than tww
+   *
+   * @param g a graph, that is not changed
+   * @param tww best tww so far, updated on improvement
+   * @param solution best solution so far, including the contractions already applied to g, updated on improvement
+   * @param lower_bound the search stops, once a solution with this tww is found
+   */
+  static void search(graph &g, Config &config, unsigned int &tww, Solution &solution, unsigned int lower_bound = 0) {
+    State state{g, config, tww, solution};
+    state.h.copy_from(g);
+    ContractionEnumeration enumeration{state.h, 0, (unsigned int)config.candidate_threads, config.order_contractions,
+                                       config.normal_form};
+    size_t memory_limit = (size_t)config.best_first_memory << 20;
+    std::vector<Entry> frontier;
+    frontier.push_back({lower_bound, 0, {{}, {}, state.h.get_first_node()->id, state.h.get_first_node()->id}});
+    size_t memory = frontier[0].memory();
+    bool depth_first = false;
+    unsigned int proven = lower_bound;
+    while (!frontier.empty() && tww > lower_bound && !state.stop && !stop_requested()) {
+      std::pop_heap(frontier.begin(), frontier.end());
+      Entry entry = std::move(frontier.back());
+      frontier.pop_back();
+      memory -= entry.memory();
+      // every open subtree has at least this bound
+      if (entry.bound >= tww) break;
+      if (entry.bound > proven) {
+        proven = entry.bound;
+        std::cout << "c Best-first B&B proved tww >= " << proven << std::endl;
+      }
+      if (!depth_first && memory > memory_limit) {
+        std::cout << "c Best-first B&B reached the memory limit with " << frontier.size()
+                  << " open states, continuing depth-first" << std::endl;
+        depth_first = true;
+      }
+      if (depth_first) {
+        search_subtree(state, enumeration, entry.task, lower_bound);
+      } else {
+        expand(state, enumeration, entry.task, lower_bound, [&](Entry &&child) {
+          memory += child.memory();
+          frontier.push_back(std::move(child));
+          std::push_heap(frontier.begin(), frontier.end());
+        });
+      }
+    }
+    std::cout << "c Best-first B&B searched " << state.nodes << " nodes, transposition table hits: "
+              << state.transpositions.hits << std::endl;
+  }
+
+private:
+  struct State {
+    graph &g;
+    Config &config;
+    unsigned int &tww;
+    Solution &solution;
+    // contractions already applied to g, before the search started
+    Solution root = g.build_solution();
+    // copy of g without its contractions, the enumeration runs on it
+    graph h{};
+    TranspositionTable transpositions{};
+    unsigned long long nodes = 0;
+    bool stop = false;
+  };
+
+  struct Entry {
+    unsigned int bound;
+    unsigned int depth;
+    SearchTask task{};
+
+    // the heap is a max heap, so the lowest bound, and among those the deepest state, is the largest entry
+    bool operator<(const Entry &other) const {
+      return bound > other.bound || (bound == other.bound && depth < other.depth);
+    }
+
+    size_t memory() const {
+      return sizeof(Entry) + task.prefix.size() * sizeof(Contraction) + task.prefix_forced.size() / 8 +
+             task.remaining.size() * sizeof(Contraction);
+    }
+  };
+
+  static void improve(State &state, graph &h, unsigned int lower_bound) {
+    std::cout << "c Branch and bound improved tww from " << state.tww << " to " << h.twin_width << std::endl;
+    state.tww = h.twin_width;
+    state.solution = state.root;
+    for (auto &&c : h.con_seq) {
+      state.solution.add_contraction(c.u, c.v);
+    }
+    state.solution.twin_width = h.twin_width;
+    // the lower bound is reached, or a cycle proves the tww of 2 optimal
+    if (state.tww <= lower_bound || (state.tww == 2 && CycleDetection::has_tww2_cycle(state.g))) {
+      state.stop = true;
+    }
+  }
+
+  /**
+   * @brief Adds the children of a subtree, that cannot be pruned, with their bounds
+   */
+  template <typename Add>
+  static void expand(State &state, ContractionEnumeration &enumeration, SearchTask &task, unsigned int lower_bound,
+                     Add add) {
+    graph &h = state.h;
+    enumeration.resume(h, task.prefix, task.prefix_forced, task.first, task.after, state.tww, task.remaining,
+                       task.remaining_forced);
+    unsigned int twin_u, twin_v;
+    while (!state.stop && enumeration.do_next_contraction(h, state.tww)) {
+      ++state.nodes;
+      if (h.n == 1) {
+        if (h.twin_width < state.tww) improve(state, h, lower_bound);
+      } else if (h.twin_width < state.tww && state.transpositions.visit(enumeration.state_hash(h), h.twin_width)) {
+        unsigned int bound = ContractionEnumeration::lookahead_bound(h, state.tww);
+        if (bound < state.tww) {
+          Entry child{bound, (unsigned int)h.con_seq.size()};
+          for (auto &&c : h.con_seq) {
+            child.task.prefix.push_back({c.u, c.v});
+          }
+          child.task.prefix_forced.assign(enumeration.forced.begin(), enumeration.forced.begin() + h.con_seq.size());
+          if (state.config.search_reductions &&
+              TwinReduction::find_near(h, &h.adj_list[h.con_seq.back().u], twin_u, twin_v)) {
+            // the last contraction created twins, contracting them first is optimal
+            child.task.first = std::min(twin_u, twin_v);
+            child.task.after = std::max(twin_u, twin_v);
+            child.task.remaining = {{child.task.first, child.task.after}};
+            child.task.remaining_forced = true;
+          } else {
+            child.task.first = child.task.after = h.get_first_node()->id;
+          }
+          add(std::move(child));
+        }
+      }
+      enumeration.skip_branch(h);
+    }
+    h.uncontract(h.con_seq.size());
+  }
+
+  /**
+   * @brief Searches a subtree depth-first, like the sequential search of BranchAndBound
+   */
+  static void search_subtree(State &state, ContractionEnumeration &enumeration, SearchTask &task,
+                             unsigned int lower_bound) {
+    graph &h = state.h;
+    enumeration.resume(h, task.prefix, task.prefix_forced, task.first, task.after, state.tww, task.remaining,
+                       task.remaining_forced);
+    unsigned int twin_u, twin_v;
+    while (!state.stop && !stop_requested() && enumeration.do_next_contraction(h, state.tww)) {
+      ++state.nodes;
+      if (h.n == 1) {  // leaf
+        if (h.twin_width < state.tww) improve(state, h, lower_bound);
+      } else if (h.twin_width >= state.tww) {
+        enumeration.skip_branch(h);
+      } else if (!state.transpositions.visit(enumeration.state_hash(h), h.twin_width)) {
+        // the same state was already explored with at most the same twin width
+        enumeration.skip_branch(h);
+      } else if (state.config.search_reductions &&
+                 TwinReduction::find_near(h, &h.adj_list[h.con_seq.back().u], twin_u, twin_v)) {
+        // the last contraction created twins, contracting them first is optimal
+        enumeration.force(h, twin_u, twin_v);
+      }
+    }
+    h.uncontract(h.con_seq.size());
+  }
+};
+
+#endif /* end of include guard: BEST_FIRST_BRANCH_AND_BOUND_HH */
@@ -1,56 +1,98 @@
 #ifndef BRANCH_AND_BOUND_HH
 #define BRANCH_AND_BOUND_HH
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+#include "../data_structures/checkpoint.hh"
 #include "../data_structures/contraction_enumeration.hh"
 #include "../data_structures/graph.hh"
+#include "../data_structures/transposition_table.hh"
+#include "../reductions/twins.hh"
 #include "../solvers/greedy.hh"
+#include "../strategies/greedy.hh"
 #include "../utils.hh"
+#include "best_first_branch_and_bound.hh"
 #include "cycle_detection.hh"
+#include "distributed_branch_and_bound.hh"
 #include "greedy_red_deg_limit.hh"
+#include "induced_subgraph_bound.hh"
+#include "parallel_branch_and_bound.hh"
+#include "sat_twin_width.hh"
 
 class BranchAndBound {
 public:
   static std::string name() { return "BranchAndBound"; }
 
-  static void solve(graph &g, Config &config) {
-    int desired_n =
-        config.search_depth ? std::max<int>(g.n - config.search_depth, 1) : 1;
+  /**
+   * @brief Contractions from a state to a single node and their tww, the next contraction is at the front
+   */
+  struct Plan {
+    std::deque<Contraction> contractions;
+    unsigned int twin_width{};
+    // contractions at the front, that are left from the window of the last search of a whole window
+    unsigned int searched{};
+  };
+
+  /**
+   * @param window_bounds lower bounds on the depth limited windows of the states by partition hash, shared by the
+   *                      greedy B&B runs of increasing depth on the same graph, nullptr: not shared
+   */
+  static void solve(graph &g, Config &config, std::unordered_map<uint64_t, unsigned int> *window_bounds = nullptr) {
+    unsigned int desired_n = config.search_depth ? std::max<int>(g.n - config.search_depth, 1) : 1;
 
     unsigned int tww = -1;
     Solution solution;
     bool skip_bnb = false;
 
+    // the exact search keeps its state in the checkpoint file, a resumed search continues from it
+    std::unique_ptr<Checkpoint> checkpoint;
+    if (!config.checkpoint_file.empty() && !config.search_depth && !config.decision_search &&
+        config.coordinator.empty() && !config.best_first_memory) {
+      checkpoint = std::make_unique<Checkpoint>(config.checkpoint_file, g);
+    }
+
     // Heuristic solution
     int old_n = g.n;
-    if (config.search_depth) {
-      Config heuristic_config = config;
-      heuristic_config.reductions.set_heuristic(false);
-      heuristic_config.reductions.set_exact(true);
-      heuristic_config.reductions.reduce_exhaustively = false;
-      // For GreedyRedDegreeLimit reductions lead to much longer runtime
-      heuristic_config.reduction_frequency = 0;
-      run_solver(g, heuristic_config, config.solver);
-      tww = g.twin_width;
+    if (checkpoint && checkpoint->resumed) {
+      Checkpoint::Search &state = checkpoint->search();
+      tww = state.tww;
       solution = g.build_solution();
-      g.uncontract(old_n - g.n);
+      for (auto &&c : state.solution) {
+        solution.add_contraction(c.u, c.v);
+      }
+      solution.twin_width = tww;
+      skip_bnb = state.finished;
+      std::cout << "c Resumed B&B with tww " << tww << " from checkpoint, " << state.tasks.size()
+                << " open subtrees, " << state.nodes << " nodes searched" << (state.finished ? ", finished" : "")
+                << std::endl;
+    } else if (config.search_depth) {
+      tww = heuristic(g, config, solution);
       std::cout << "c Heuristic tww: " << tww << std::endl;
     } else {
-      if (g.n < 1000) { // Greedy B&B with depth 3
+      // once a stop is requested, only the plain red deg limit heuristic runs, to have a complete solution
+      // the greedy B&B runs start from the same states, a deeper run reuses the window bounds of the shallower ones
+      std::unordered_map<uint64_t, unsigned int> ladder_bounds;
+      if (g.n < 1000 && !stop_requested()) { // Greedy B&B with depth 3
         Config c{};
         c.strategy = Strategy::GREEDY_BB;
         c.solver = Solver::RED_DEG_LIMIT;
         c.search_depth = 3;
-        run_strategy(g, c, Strategy::GREEDY_BB);
+        greedy_depth_limited_bb(g, c, &ladder_bounds);
+        complete_stopped(g);
         tww = g.twin_width;
         solution = g.build_solution();
         g.uncontract(old_n - g.n);
       }
-      if (g.n < 500) { // Greedy B&B with depth 4
+      if (g.n < 500 && !stop_requested()) { // Greedy B&B with depth 4
         Config c{};
         c.strategy = Strategy::GREEDY_BB;
         c.solver = Solver::RED_DEG_LIMIT;
         c.search_depth = 4;
-        run_strategy(g, c, Strategy::GREEDY_BB);
+        greedy_depth_limited_bb(g, c, &ladder_bounds);
+        complete_stopped(g);
         if (g.twin_width < tww) {
           tww = g.twin_width;
           solution = g.build_solution();
@@ -58,13 +100,14 @@ public:
         g.uncontract(old_n - g.n);
       }
       if (g.n < 100) { // Greedy B&B with depth 5+
-        for (int i = 5; i <= 10; ++i) {
+        for (int i = 5; i <= 10 && !stop_requested(); ++i) {
 
           Config c{};
           c.strategy = Strategy::GREEDY_BB;
           c.solver = Solver::RED_DEG_LIMIT;
           c.search_depth = i;
-          run_strategy(g, c, Strategy::GREEDY_BB);
+          greedy_depth_limited_bb(g, c, &ladder_bounds);
+          complete_stopped(g);
           if (g.twin_width < tww) {
             tww = g.twin_width;
             solution = g.build_solution();
@@ -72,7 +115,7 @@ public:
           g.uncontract(old_n - g.n);
         }
       }
-      if (g.n < 300) { // Greedy
+      if (g.n < 300 && !stop_requested()) { // Greedy
         Config c{};
         c.strategy = Strategy::SOLVER;
         c.solver = Solver::GREEDY;
@@ -98,7 +141,7 @@ public:
       conf.strategy = Strategy::SOLVER;
       conf.solver = Solver::RED_DEG_LIMIT_RANDOM;
       conf.reductions.reduce_exhaustively = true;
-      for (int i = 0; i < 25; ++i) {
+      for (int i = 0; i < 25 && !stop_requested(); ++i) {
         run_strategy(g, c, Strategy::SOLVER);
         if (g.twin_width < tww) {
           tww = g.twin_width;
@@ -124,12 +167,249 @@ public:
       }
     }
 
+    // Every solution starts with one contraction, so no solution is better than the best first contraction
+    unsigned int lower_bound = 0;
+    if (!skip_bnb && g.n > desired_n && !stop_requested()) {
+      lower_bound = ContractionEnumeration::lookahead_bound(g, tww);
+      std::cout << "c Lookahead lower bound: " << lower_bound << std::endl;
+      if (lower_bound >= tww) {
+        skip_bnb = true;
+      }
+    }
+
+    // the SAT decisions raise the lower bound, until one of them finds a solution or gives up
+    if (!skip_bnb && config.sat_conflicts && !config.search_depth && !stop_requested()) {
+      SatTwinWidth::search(g, lower_bound, tww, solution, config.sat_conflicts, true);
+      std::cout << "c SAT lower bound: " << lower_bound << std::endl;
+      if (lower_bound >= tww) {
+        skip_bnb = true;
+      }
+    }
+
+    // a window of a state extends a shallower window of it, so it is at least as wide as the best shallower window,
+    // that a shallower greedy B&B run found, or as the heuristic of that run, if no shallower window beat it
+    // the tww of a window includes the contractions leading to the state, only a larger tww bounds the window itself,
+    // independent of how the state is reached
+    unsigned int *window_bound = nullptr;
+    if (!skip_bnb && config.search_depth && window_bounds && !stop_requested()) {
+      g.enable_partition_hash();
+      window_bound = &(*window_bounds)[g.partition_hash];
+      lower_bound = std::max(lower_bound, *window_bound);
+      if (lower_bound >= tww) {
+        skip_bnb = true;
+      }
+    }
+
     if (skip_bnb) {
       std::cout << "c Skipping B&B because solution cannot be better"
                 << std::endl;
+    } else if (stop_requested()) {
+      std::cout << "c Skipping B&B because a stop was requested" << std::endl;
+    } else if (config.subgraph_threads && !config.search_depth && config.coordinator.empty() &&
+               !config.best_first_memory) {
+      // the engine raises the lower bound of the search, while it runs
+      InducedSubgraphBound subgraphs{g, config, tww, lower_bound};
+      if (config.decision_search) {
+        decide(g, config, tww, solution, lower_bound, &subgraphs.bound);
+      } else {
+        search(g, config, tww, solution, lower_bound, checkpoint.get(), &subgraphs.bound);
+      }
+      if (subgraphs.bound >= tww) {
+        std::cout << "c Branch and bound stopped at the induced subgraph lower bound" << std::endl;
+      }
+    } else if (config.decision_search) {
+      decide(g, config, tww, solution, lower_bound);
     } else {
-      ContractionEnumeration contraction_enumeration{g, config.search_depth};
-      while (contraction_enumeration.do_next_contraction(g, tww)) {
+      search(g, config, tww, solution, lower_bound, checkpoint.get());
+    }
+
+    if (window_bound && tww > g.twin_width && !stop_requested()) {
+      // tww is the best window, or no window beats the heuristic
+      *window_bound = std::max(*window_bound, tww);
+    }
+
+    if (checkpoint && !stop_requested()) {
+      // the search is complete, a resumed run does not repeat it
+      Checkpoint::Search &state = checkpoint->search();
+      state.finished = true;
+      state.tww = tww;
+      state.solution.assign(solution.contractions.begin() + g.con_seq.size(), solution.contractions.end());
+      state.tasks.clear();
+      checkpoint->write();
+    }
+
+    // apply best solution
+    g.uncontract(solution.contractions.size());
+    for (auto &contr : solution.contractions) {
+      g.contract(contr.u, contr.v);
+    }
+  }
+
+  /**
+   * @brief One step of the rolling horizon greedy B&B (see Config::rolling_horizon)
+   *        the plan leads from the current state to a single node, its first contractions are a window of the depth
+   *        limited search, a better window replaces the plan together with a completion, unless the completion is
+   *        worse than the plan
+   *        the search is bounded by the best window of the previous step, every window after the first contraction of
+   *        the plan extends a window of the previous state by one contraction, so it is at least as wide, once the
+   *        window of the plan reaches this bound, it is the best window and nothing is searched
+   *        the window of the plan is the best window of the previous step without its first contraction and with the
+   *        next contraction of the plan, so only its new last contraction is searched, the whole window is only
+   *        searched, if that does not reach the bound and the window of the last such search is committed
+   *
+   * @param plan contractions from the current state to a single node and their tww, a heuristic solution, if empty
+   * @param window_bound lower bound on the windows of the state, updated for the state after the first contraction of
+   *                     the plan
+   */
+  static void improve_plan(graph &g, Config &config, Plan &plan, unsigned int &window_bound) {
+    unsigned int history = g.con_seq.size();
+    // the heuristic of a depth limited search stops after search_depth contractions as well, the plan is complete
+    // without a depth limit the B&B solver would search exactly, so the plan is completed by its own heuristic
+    Config completion_config = config;
+    completion_config.search_depth = 0;
+    if (completion_config.solver == Solver::BRANCH_AND_BOUND) completion_config.solver = Solver::RED_DEG_LIMIT;
+    Solution solution;
+    if (plan.contractions.empty()) {
+      plan.twin_width = heuristic(g, completion_config, solution);
+      plan.contractions.assign(solution.contractions.begin() + history, solution.contractions.end());
+      // a stopped heuristic leaves no plan
+      if (plan.contractions.empty()) return;
+    }
+    // a stopped heuristic leaves a shorter plan
+    unsigned int window_size = std::min<size_t>(std::min<int>(config.search_depth, g.n - 1), plan.contractions.size());
+    for (unsigned int i = 0; i + 1 < window_size; ++i) {
+      g.contract(plan.contractions[i].u, plan.contractions[i].v);
+    }
+    g.contract(plan.contractions[window_size - 1].u, plan.contractions[window_size - 1].v);
+    unsigned int tww = g.twin_width;
+    g.uncontract();
+
+    // the last contraction of the window is new, so it is searched first
+    Config level_config = config;
+    level_config.search_depth = 1;
+    unsigned int plan_window = tww;
+    Solution window;
+    search(g, level_config, tww, window, window_bound);
+    g.uncontract(g.con_seq.size() - history);
+    if (tww < plan_window) {
+      replan(g, completion_config, plan, {window.contractions.begin() + history, window.contractions.end()},
+             window_size);
+    }
+
+    unsigned int lower_bound = std::max<unsigned int>(window_bound, ContractionEnumeration::lookahead_bound(g, tww));
+    if (lower_bound < tww && !plan.searched) {
+      // only windows, that beat the window of the plan, are searched
+      plan_window = tww;
+      search(g, config, tww, window, lower_bound);
+      if (tww < plan_window) {
+        replan(g, completion_config, plan, {window.contractions.begin() + history, window.contractions.end()},
+               window_size);
+      }
+      plan.searched = window_size;
+      lower_bound = tww;
+    }
+    // a stopped search found no bound
+    window_bound = stop_requested() ? 0 : lower_bound;
+  }
+
+private:
+  /**
+   * @brief Replaces the front of the plan by a window and completes it, unless the completion is worse than the plan
+   *        the rest of the plan completes the window, if all of its contractions are still possible and it is not
+   *        worse than the plan, the heuristic only runs otherwise
+   *
+   * @param window contractions from the current state
+   * @param replaced contractions at the front of the plan, that the window replaces
+   */
+  static void replan(graph &g, Config &completion_config, Plan &plan, const std::vector<Contraction> &window,
+                     unsigned int replaced) {
+    unsigned int history = g.con_seq.size();
+    for (auto &&c : window) {
+      g.contract(c.u, c.v);
+    }
+    unsigned int window_end = g.con_seq.size();
+    bool replayed = true;
+    for (auto c = plan.contractions.begin() + replaced; replayed && c != plan.contractions.end(); ++c) {
+      replayed = c->u != c->v && g.adj_list[c->u].active && g.adj_list[c->v].active;
+      if (replayed) g.contract(c->u, c->v);
+    }
+    // on a tie the better window is more promising
+    if (replayed && g.n == 1 && g.twin_width <= plan.twin_width) {
+      plan.twin_width = g.twin_width;
+      plan.contractions.erase(plan.contractions.begin(), plan.contractions.begin() + replaced);
+      plan.contractions.insert(plan.contractions.begin(), window.begin(), window.end());
+    } else {
+      g.uncontract(g.con_seq.size() - window_end);
+      Solution solution;
+      unsigned int completion = g.n > 1 ? heuristic(g, completion_config, solution) : g.twin_width;
+      if (completion <= plan.twin_width) {
+        plan.twin_width = completion;
+        plan.contractions.assign(window.begin(), window.end());
+        if (g.n > 1) {
+          plan.contractions.insert(plan.contractions.end(), solution.contractions.begin() + g.con_seq.size(),
+                                   solution.contractions.end());
+        }
+      }
+    }
+    g.uncontract(g.con_seq.size() - history);
+  }
+
+  /**
+   * @brief Runs the heuristic of a depth limited search (config.solver) with exact reductions only
+   *
+   * @param solution heuristic solution, including the contractions already applied to g, which is not changed
+   * @return unsigned int tww of the solution
+   */
+  static unsigned int heuristic(graph &g, Config &config, Solution &solution) {
+    int old_n = g.n;
+    Config heuristic_config = config;
+    heuristic_config.reductions.set_heuristic(false);
+    heuristic_config.reductions.set_exact(true);
+    heuristic_config.reductions.reduce_exhaustively = false;
+    // For GreedyRedDegreeLimit reductions lead to much longer runtime
+    heuristic_config.reduction_frequency = 0;
+    run_solver(g, heuristic_config, config.solver);
+    unsigned int tww = g.twin_width;
+    solution = g.build_solution();
+    g.uncontract(old_n - g.n);
+    return tww;
+  }
+
+  /**
+   * @brief Searches for a solution with a tww lower than tww
+   *        states are never split into components: a contraction only merges two nodes, so every state is a quotient
+   *        of the root, and of its complement with red edges kept, a state is disconnected or has a disconnected
+   *        complement only if the root has, and solve_components already splits those
+   *
+   * @param tww best tww so far, updated on improvement
+   * @param solution best solution so far, updated on improvement
+   * @param lower_bound the search stops, once a solution with this tww is found
+   * @param checkpoint if given, the search writes its state to it, see ParallelBranchAndBound::search
+   * @param shared_lower_bound lower bound, that other threads raise during the search, the search stops once it
+   *                           reaches the best tww, nullptr: none
+   */
+  static void search(graph &g, Config &config, unsigned int &tww, Solution &solution, unsigned int lower_bound,
+                     Checkpoint *checkpoint = nullptr, const std::atomic<unsigned int> *shared_lower_bound = nullptr) {
+    unsigned int desired_n = config.search_depth ? std::max<int>(g.n - config.search_depth, 1) : 1;
+    unsigned int root_contractions = g.con_seq.size();
+
+    if (!config.coordinator.empty() && !config.search_depth) {
+      // worker processes search the subtrees
+      DistributedBranchAndBound::search(g, config, tww, solution, lower_bound);
+    } else if (config.best_first_memory && !config.search_depth) {
+      BestFirstBranchAndBound::search(g, config, tww, solution, lower_bound);
+    } else if (config.threads > 1 || checkpoint) {
+      // the task queue of the parallel search is its state, so it also runs searches with checkpoints
+      ParallelBranchAndBound::search(g, config, tww, solution, lower_bound, checkpoint, shared_lower_bound);
+    } else {
+      ContractionEnumeration contraction_enumeration{g, config.search_depth, (unsigned int)config.candidate_threads,
+                                                     config.order_contractions, config.normal_form};
+      // the steps of a depth limited search and the decisions search many times, they reuse the table of the thread
+      static thread_local TranspositionTable transpositions;
+      transpositions.clear();
+      unsigned int twin_u, twin_v;
+      while (!stop_requested() && !lower_bound_reached(shared_lower_bound, tww) &&
+             contraction_enumeration.do_next_contraction(g, tww)) {
         if (g.n == desired_n) { // leaf
           if (g.twin_width < tww) {
             if (!config.search_depth) {
@@ -144,18 +424,57 @@ public:
             }
             tww = g.twin_width;
             solution = g.build_solution();
+            // The lower bound is reached, the solution is optimal
+            if (tww <= lower_bound) {
+              break;
+            }
           }
         } else if (g.twin_width >= tww) {
           contraction_enumeration.skip_branch(g);
+        } else if (!transpositions.visit(contraction_enumeration.state_hash(g), g.twin_width)) {
+          // the same state was already explored with at most the same twin width
+          contraction_enumeration.skip_branch(g);
+        } else if (config.search_reductions &&
+                   TwinReduction::find_near(g, &g.adj_list[g.con_seq.back().u], twin_u, twin_v)) {
+          // the last contraction created twins, contracting them first is optimal
+          contraction_enumeration.force(g, twin_u, twin_v);
         }
-        // TODO: possible to add reductions?
       }
+      if (!config.search_depth) {
+        std::cout << "c Transposition table hits: " << transpositions.hits << std::endl;
+      }
+      // a search stopped at a solution leaves its contractions applied
+      g.uncontract(g.con_seq.size() - root_contractions);
     }
+  }
 
-    // apply best solution
-    g.uncontract(solution.contractions.size());
-    for (auto &contr : solution.contractions) {
-      g.contract(contr.u, contr.v);
+  /**
+   * @brief Whether another thread proved, that no solution is better than tww
+   */
+  static bool lower_bound_reached(const std::atomic<unsigned int> *shared_lower_bound, unsigned int tww) {
+    return shared_lower_bound && *shared_lower_bound >= tww;
+  }
+
+  /**
+   * @brief Finds the optimal tww between lower_bound and tww by decision searches "tww <= k?"
+   *        a decision search is a search with incumbent k + 1, that stops at the first solution, as its limit never
+   *        changes, it prunes with the tightest bound from the start
+   *        k is increased from the lower bound, or bisected between both bounds
+   */
+  static void decide(graph &g, Config &config, unsigned int &tww, Solution &solution, unsigned int lower_bound,
+                     const std::atomic<unsigned int> *shared_lower_bound = nullptr) {
+    unsigned int low = lower_bound;
+    while (low < tww) {
+      unsigned int k = config.decision_search == 1 ? low : low + (tww - 1 - low) / 2;
+      unsigned int bound = k + 1;
+      search(g, config, bound, solution, k, nullptr, shared_lower_bound);
+      if (bound > k && stop_requested()) break;
+      std::cout << "c Decision tww <= " << k << ": " << (bound <= k ? "yes" : "no") << std::endl;
+      if (bound <= k) {
+        tww = bound;
+      } else {
+        low = k + 1;
+      }
     }
   }
 };
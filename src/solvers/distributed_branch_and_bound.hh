@@ -0,0 +1,564 @@
+#ifndef DISTRIBUTED_BRANCH_AND_BOUND_HH
+#define DISTRIBUTED_BRANCH_AND_BOUND_HH
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/checkpoint.hh"
+#include "../data_structures/contraction_enumeration.hh"
+#include "../data_structures/graph.hh"
+#include "../data_structures/transposition_table.hh"
+#include "../reductions/twins.hh"
+#include "../utils.hh"
+#include "cycle_detection.hh"
+
+/**
+ * @brief Branch and bound with worker processes, connected by TCP or Unix sockets
+ *        the coordinator sends the root of each search to its workers, splits the search at a shallow depth into
+ *        subtrees and hands them out like the tasks of ParallelBranchAndBound, once its queue is empty, it asks busy
+ *        workers to split off the remaining contractions of their shallowest open level
+ *        workers report improved solutions, the coordinator sends the new bound to all of them, the subtree of a
+ *        worker, whose connection fails, is queued again
+ *        messages are lines of text, tagged with the number of the search they belong to, workers may connect and
+ *        leave at any time
+ */
+class DistributedBranchAndBound {
+public:
+  /**
+   * @brief Searches for a contraction sequence with a tww lower than tww with the workers connected to
+   *        config.coordinator, waits for workers, if there are none
+   *
+   * @param g a graph, that is not changed
+   * @param tww best tww so far, updated on improvement
+   * @param solution best solution so far, including the contractions already applied to g, updated on improvement
+   * @param lower_bound the search stops, once a solution with this tww is found
+   */
+  static void search(graph &g, Config &config, unsigned int &tww, Solution &solution, unsigned int lower_bound = 0) {
+    Coordinator &coordinator = get_coordinator();
+    if (coordinator.listen_fd < 0) listen(config);
+    unsigned int id = ++coordinator.search_id;
+    graph h;
+    h.copy_from(g);
+    std::ostringstream root;
+    root << "search " << id << " " << config.order_contractions << " " << config.normal_form << " "
+         << config.search_reductions << " " << tww << " ";
+    h.write_state(root);
+    coordinator.root = root.str();
+    coordinator.root_solution = g.build_solution();
+    coordinator.best = tww;
+    coordinator.lower_bound = lower_bound;
+    coordinator.done = false;
+    coordinator.nodes = 0;
+    for (auto &&worker : coordinator.workers) {
+      worker->connection.send(coordinator.root);
+    }
+
+    // subtrees at a shallow depth, the children of the first tasks follow the others, so the queue stays ordered
+    std::deque<SearchTask> &tasks = coordinator.tasks;
+    tasks.clear();
+    tasks.push_back({{}, {}, h.get_first_node()->id, h.get_first_node()->id});
+    ContractionEnumeration enumeration{h, 0, 1, config.order_contractions, config.normal_form};
+    unsigned int target = TASKS_PER_WORKER * std::max<unsigned int>(coordinator.workers.size(), 1);
+    while (!coordinator.done && !tasks.empty() && tasks.size() < target &&
+           tasks.front().prefix.size() < MAX_SPLIT_DEPTH) {
+      SearchTask task = std::move(tasks.front());
+      tasks.pop_front();
+      expand(coordinator, config, g, h, enumeration, task);
+    }
+
+    bool waiting_reported = false;
+    while (!coordinator.done && !stop_requested()) {
+      unsigned int idle = 0;
+      bool busy = false;
+      for (auto &&worker : coordinator.workers) {
+        if (!worker->busy && !tasks.empty()) {
+          worker->task = std::move(tasks.front());
+          tasks.pop_front();
+          std::ostringstream message;
+          message << "task " << id << " ";
+          Checkpoint::write_task(message, worker->task);
+          worker->connection.send(message.str());
+          worker->busy = true;
+        }
+        if (worker->busy) {
+          busy = true;
+        } else {
+          ++idle;
+        }
+      }
+      if (tasks.empty() && !busy) break;
+      if (tasks.empty()) {
+        // like idle threads of ParallelBranchAndBound, idle workers get work split off from busy ones
+        for (auto &&worker : coordinator.workers) {
+          if (!idle) break;
+          if (worker->busy && !worker->sharing) {
+            worker->connection.send("share " + std::to_string(id));
+            worker->sharing = true;
+            --idle;
+          }
+        }
+      }
+      if (coordinator.workers.empty() && !waiting_reported) {
+        std::cout << "c Waiting for workers at " << config.coordinator << std::endl;
+        waiting_reported = true;
+      }
+      receive(coordinator, g);
+    }
+    for (auto &&worker : coordinator.workers) {
+      worker->connection.send("end " + std::to_string(id));
+      worker->busy = false;
+      worker->sharing = false;
+    }
+    std::cout << "c Distributed B&B searched " << coordinator.nodes << " nodes with " << coordinator.workers.size()
+              << " workers" << std::endl;
+    if (coordinator.best < tww) {
+      tww = coordinator.best;
+      solution = coordinator.solution;
+    }
+  }
+
+  /**
+   * @brief Listens at config.coordinator for workers, a run listens from its start, so its workers notice its end,
+   *        even if it never searches
+   */
+  static void listen(Config &config) {
+    Coordinator &coordinator = get_coordinator();
+    coordinator.listen_fd = open_socket(config.coordinator, true);
+    if (coordinator.listen_fd < 0) {
+      throw std::runtime_error("Cannot listen at " + config.coordinator + ": " + std::strerror(errno));
+    }
+    std::cout << "c Coordinator listening at " << config.coordinator << std::endl;
+  }
+
+  /**
+   * @brief Connects to the coordinator at config.worker and searches the subtrees it sends, until it closes the
+   *        connection or a stop is requested
+   */
+  static void work(Config &config) {
+    Connection connection;
+    std::cout << "c Connecting to coordinator at " << config.worker << std::endl;
+    for (int attempt = 0; (connection.fd = open_socket(config.worker, false)) < 0; ++attempt) {
+      // the coordinator may not listen yet
+      if (stop_requested() || attempt == CONNECT_ATTEMPTS) {
+        std::cout << "c No coordinator at " << config.worker << std::endl;
+        return;
+      }
+      usleep(POLL_MILLISECONDS * 1000);
+    }
+    std::cout << "c Connected to coordinator" << std::endl;
+    Search search;
+    std::string line;
+    unsigned long long nodes = 0;
+    while (!stop_requested()) {
+      if (!connection.receive(line, POLL_MILLISECONDS)) {
+        if (connection.closed) break;
+        continue;
+      }
+      std::istringstream message{line};
+      std::string word;
+      unsigned int id;
+      message >> word >> id;
+      if (word == "search") {
+        bool ordered, normal_form;
+        search.id = id;
+        message >> ordered >> normal_form >> search.search_reductions >> search.best;
+        search.g = std::make_unique<graph>();
+        search.g->read_state(message);
+        search.enumeration = std::make_unique<ContractionEnumeration>(
+            *search.g, 0, (unsigned int)config.candidate_threads, ordered, normal_form);
+        search.transpositions = std::make_unique<TranspositionTable>();
+      } else if (word == "task" && id == search.id && search.g) {
+        SearchTask task;
+        Checkpoint::read_task(message, task);
+        unsigned long long task_nodes = search_task(connection, search, task);
+        nodes += task_nodes;
+        // a stopped worker leaves its subtree to the coordinator, which queues it again
+        if (search.g && !stop_requested()) {
+          connection.send("finished " + std::to_string(id) + " " + std::to_string(task_nodes));
+        }
+      } else {
+        handle(connection, search, word, id, message);
+      }
+    }
+    close(connection.fd);
+    std::cout << "c Worker searched " << nodes << " nodes" << std::endl;
+  }
+
+private:
+  // the coordinator splits the search into this many tasks per connected worker, at most at this depth
+  static constexpr unsigned int TASKS_PER_WORKER = 16;
+  static constexpr unsigned int MAX_SPLIT_DEPTH = 3;
+  // nodes a worker searches between two checks for messages
+  static constexpr unsigned long long MESSAGE_CHECK_NODES = 1024;
+  static constexpr int POLL_MILLISECONDS = 100;
+  // a worker tries to connect for a minute
+  static constexpr int CONNECT_ATTEMPTS = 600;
+
+  // line based messages over a socket
+  struct Connection {
+    int fd = -1;
+    bool closed = false;
+    std::string buffer;
+
+    void send(const std::string &line) {
+      std::string message = line + "\n";
+      size_t sent = 0;
+      while (!closed && sent < message.size()) {
+        ssize_t result = ::send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) {
+          closed = true;
+        } else {
+          sent += result;
+        }
+      }
+    }
+
+    /**
+     * @brief Takes the next line, reads from the socket, if there is none yet
+     *
+     * @param timeout milliseconds to wait for data, -1 to block
+     * @return bool if there was a line, false on a timeout, a signal or a closed connection
+     */
+    bool receive(std::string &line, int timeout) {
+      while (true) {
+        size_t end = buffer.find('\n');
+        if (end != std::string::npos) {
+          line = buffer.substr(0, end);
+          buffer.erase(0, end + 1);
+          return true;
+        }
+        if (closed) return false;
+        pollfd p{fd, POLLIN, 0};
+        if (poll(&p, 1, timeout) <= 0) return false;
+        char data[4096];
+        ssize_t size = read(fd, data, sizeof(data));
+        if (size < 0 && errno == EINTR) return false;
+        if (size <= 0) {
+          closed = true;
+          return false;
+        }
+        buffer.append(data, size);
+        // the next round only reads again, if the data did not complete a line
+        timeout = 0;
+      }
+    }
+  };
+
+  // a worker process, as seen by the coordinator
+  struct Worker {
+    Connection connection;
+    bool busy = false;
+    // a share request was sent, but not answered yet
+    bool sharing = false;
+    SearchTask task;
+  };
+
+  // the coordinator keeps its socket and workers for all searches of the run
+  struct Coordinator {
+    int listen_fd = -1;
+    std::vector<std::unique_ptr<Worker>> workers;
+    unsigned int search_id = 0;
+    // state of the current search
+    std::string root;
+    Solution root_solution;
+    Solution solution;
+    unsigned int best;
+    unsigned int lower_bound;
+    bool done;
+    unsigned long long nodes;
+    std::deque<SearchTask> tasks;
+  };
+
+  // the current search of a worker process
+  struct Search {
+    unsigned int id = 0;
+    bool search_reductions = false;
+    unsigned int best = -1;
+    std::unique_ptr<graph> g;
+    std::unique_ptr<ContractionEnumeration> enumeration;
+    std::unique_ptr<TranspositionTable> transpositions;
+  };
+
+  static Coordinator &get_coordinator() {
+    static Coordinator coordinator;
+    return coordinator;
+  }
+
+  /**
+   * @brief Opens a socket for an address, host:port for TCP, otherwise the path of a Unix socket
+   *
+   * @param listen listen at the address, otherwise connect to it
+   * @return int the socket, -1 on failure
+   */
+  static int open_socket(const std::string &address, bool listen) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+      sockaddr_un addr{};
+      addr.sun_family = AF_UNIX;
+      std::strncpy(addr.sun_path, address.c_str(), sizeof(addr.sun_path) - 1);
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (fd < 0) return -1;
+      if (listen) unlink(address.c_str());
+      int result = listen ? bind(fd, (sockaddr *)&addr, sizeof(addr)) : connect(fd, (sockaddr *)&addr, sizeof(addr));
+      if (result < 0 || (listen && ::listen(fd, SOMAXCONN) < 0)) {
+        close(fd);
+        return -1;
+      }
+      return fd;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listen ? AI_PASSIVE : 0;
+    addrinfo *addresses;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addresses)) return -1;
+    int fd = -1;
+    for (addrinfo *a = addresses; a; a = a->ai_next) {
+      fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (fd < 0) continue;
+      int one = 1;
+      if (listen) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (!bind(fd, a->ai_addr, a->ai_addrlen) && !::listen(fd, SOMAXCONN)) break;
+      } else if (!connect(fd, a->ai_addr, a->ai_addrlen)) {
+        // messages are small and answered at once
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        break;
+      }
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(addresses);
+    return fd;
+  }
+
+  /**
+   * @brief Queues the children of a task as tasks, leaves among them are solutions
+   */
+  static void expand(Coordinator &coordinator, Config &config, graph &root, graph &h,
+                     ContractionEnumeration &enumeration, SearchTask &task) {
+    enumeration.resume(h, task.prefix, task.prefix_forced, task.first, task.after, coordinator.best, task.remaining,
+                       task.remaining_forced);
+    unsigned int twin_u, twin_v;
+    while (!coordinator.done && enumeration.do_next_contraction(h, coordinator.best)) {
+      ++coordinator.nodes;
+      if (h.n == 1) {
+        std::vector<Contraction> contractions;
+        for (auto &&c : h.con_seq) {
+          contractions.push_back({c.u, c.v});
+        }
+        improve(coordinator, root, h.twin_width, contractions);
+      } else if (h.twin_width < coordinator.best) {
+        SearchTask child;
+        for (auto &&c : h.con_seq) {
+          child.prefix.push_back({c.u, c.v});
+        }
+        child.prefix_forced.assign(enumeration.forced.begin(), enumeration.forced.begin() + h.con_seq.size());
+        if (config.search_reductions &&
+            TwinReduction::find_near(h, &h.adj_list[h.con_seq.back().u], twin_u, twin_v)) {
+          // the subtree of the child is the forced contraction of its twins
+          child.first = std::min(twin_u, twin_v);
+          child.after = std::max(twin_u, twin_v);
+          child.remaining = {{child.first, child.after}};
+          child.remaining_forced = true;
+        } else {
+          child.first = child.after = h.get_first_node()->id;
+        }
+        coordinator.tasks.push_back(std::move(child));
+      }
+      enumeration.skip_branch(h);
+    }
+    h.uncontract(h.con_seq.size());
+  }
+
+  static void improve(Coordinator &coordinator, graph &root, unsigned int tww,
+                      const std::vector<Contraction> &contractions) {
+    if (tww >= coordinator.best) return;
+    std::cout << "c Branch and bound improved tww from " << coordinator.best << " to " << tww << std::endl;
+    coordinator.best = tww;
+    coordinator.solution = coordinator.root_solution;
+    for (auto &&c : contractions) {
+      coordinator.solution.add_contraction(c.u, c.v);
+    }
+    coordinator.solution.twin_width = tww;
+    // the lower bound is reached, or a cycle proves the tww of 2 optimal
+    if (tww <= coordinator.lower_bound || (tww == 2 && CycleDetection::has_tww2_cycle(root))) {
+      coordinator.done = true;
+    }
+    std::string message = "bound " + std::to_string(coordinator.search_id) + " " + std::to_string(tww);
+    for (auto &&worker : coordinator.workers) {
+      worker->connection.send(message);
+    }
+  }
+
+  /**
+   * @brief Waits for new workers and messages of the workers, requeues the tasks of failed workers
+   */
+  static void receive(Coordinator &coordinator, graph &root) {
+    std::vector<pollfd> fds{{coordinator.listen_fd, POLLIN, 0}};
+    for (auto &&worker : coordinator.workers) {
+      fds.push_back({worker->connection.fd, POLLIN, 0});
+    }
+    if (poll(fds.data(), fds.size(), POLL_MILLISECONDS) <= 0) return;
+    std::string line;
+    for (unsigned int i = 1; i < fds.size(); ++i) {
+      if (!fds[i].revents) continue;
+      Worker &worker = *coordinator.workers[i - 1];
+      while (!coordinator.done && worker.connection.receive(line, 0)) {
+        std::istringstream message{line};
+        std::string word;
+        unsigned int id;
+        message >> word >> id;
+        // messages of earlier searches are outdated
+        if (id != coordinator.search_id) continue;
+        if (word == "improve") {
+          unsigned int tww;
+          std::vector<Contraction> contractions;
+          message >> tww;
+          Checkpoint::read_contractions(message, contractions);
+          improve(coordinator, root, tww, contractions);
+        } else if (word == "task") {
+          SearchTask task;
+          Checkpoint::read_task(message, task);
+          coordinator.tasks.push_back(std::move(task));
+          worker.sharing = false;
+        } else if (word == "unshared") {
+          worker.sharing = false;
+        } else if (word == "finished") {
+          unsigned long long nodes;
+          message >> nodes;
+          coordinator.nodes += nodes;
+          worker.busy = false;
+          worker.sharing = false;
+        }
+      }
+    }
+    for (auto it = coordinator.workers.begin(); it != coordinator.workers.end();) {
+      if (!(*it)->connection.closed) {
+        ++it;
+        continue;
+      }
+      std::cout << "c Lost a worker" << ((*it)->busy ? ", its subtree is queued again" : "") << std::endl;
+      if ((*it)->busy) coordinator.tasks.push_front(std::move((*it)->task));
+      close((*it)->connection.fd);
+      it = coordinator.workers.erase(it);
+    }
+    if (fds[0].revents) {
+      int fd = accept(coordinator.listen_fd, nullptr, nullptr);
+      if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        coordinator.workers.push_back(std::make_unique<Worker>());
+        Worker &worker = *coordinator.workers.back();
+        worker.connection.fd = fd;
+        worker.connection.send(coordinator.root);
+        worker.connection.send("bound " + std::to_string(coordinator.search_id) + " " +
+                               std::to_string(coordinator.best));
+        std::cout << "c Worker connected, " << coordinator.workers.size() << " workers" << std::endl;
+      }
+    }
+  }
+
+  /**
+   * @brief Handles a message of the coordinator, that is not a new search or task
+   */
+  static void handle(Connection &connection, Search &search, const std::string &word, unsigned int id,
+                     std::istringstream &message) {
+    if (id != search.id) return;
+    if (word == "bound") {
+      unsigned int bound;
+      message >> bound;
+      search.best = std::min(search.best, bound);
+    } else if (word == "share") {
+      SearchTask task;
+      if (search.g && search.g->con_seq.size() &&
+          search.enumeration->split(*search.g, task.prefix, task.prefix_forced, task.first, task.after,
+                                    task.remaining)) {
+        std::ostringstream answer;
+        answer << "task " << id << " ";
+        Checkpoint::write_task(answer, task);
+        connection.send(answer.str());
+      } else {
+        connection.send("unshared " + std::to_string(id));
+      }
+    } else if (word == "end") {
+      search.g.reset();
+      search.enumeration.reset();
+      search.transpositions.reset();
+    }
+  }
+
+  /**
+   * @brief Searches a subtree, like a worker thread of ParallelBranchAndBound, answers messages in between
+   *
+   * @return unsigned long long the number of searched nodes
+   */
+  static unsigned long long search_task(Connection &connection, Search &search, SearchTask &task) {
+    graph &g = *search.g;
+    ContractionEnumeration &enumeration = *search.enumeration;
+    enumeration.resume(g, task.prefix, task.prefix_forced, task.first, task.after, search.best, task.remaining,
+                       task.remaining_forced);
+    unsigned int twin_u, twin_v;
+    unsigned long long nodes = 0;
+    std::string line;
+    while (enumeration.do_next_contraction(g, search.best)) {
+      ++nodes;
+      if (g.n == 1) {  // leaf
+        if (g.twin_width < search.best) {
+          search.best = g.twin_width;
+          std::ostringstream message;
+          message << "improve " << search.id << " " << g.twin_width << " ";
+          std::vector<Contraction> contractions;
+          for (auto &&c : g.con_seq) {
+            contractions.push_back({c.u, c.v});
+          }
+          Checkpoint::write_contractions(message, contractions);
+          connection.send(message.str());
+        }
+      } else if (g.twin_width >= search.best) {
+        enumeration.skip_branch(g);
+      } else if (!search.transpositions->visit(enumeration.state_hash(g), g.twin_width)) {
+        // the same state was already explored by this worker with at most the same twin width
+        enumeration.skip_branch(g);
+      } else if (search.search_reductions &&
+                 TwinReduction::find_near(g, &g.adj_list[g.con_seq.back().u], twin_u, twin_v)) {
+        // the last contraction created twins, contracting them first is optimal
+        enumeration.force(g, twin_u, twin_v);
+      }
+      if (nodes % MESSAGE_CHECK_NODES == 0) {
+        while (connection.receive(line, 0)) {
+          std::istringstream message{line};
+          std::string word;
+          unsigned int id;
+          message >> word >> id;
+          handle(connection, search, word, id, message);
+          if (!search.g) return nodes;
+        }
+        if (connection.closed || stop_requested()) break;
+      }
+    }
+    g.uncontract(g.con_seq.size());
+    return nodes;
+  }
+};
+
+#endif /* end of include guard: DISTRIBUTED_BRANCH_AND_BOUND_HH */
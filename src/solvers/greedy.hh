@@ -1,9 +1,10 @@
 #ifndef GREEDY_HH
 #define GREEDY_HH
 
-#include <climits>
-
 #include "../data_structures/graph.hh"
+#include "../data_structures/pair_queue.hh"
+#include "../data_structures/pair_scoring.hh"
+#include "../utils.hh"
 
 // TODO: this greedy strategy is shit, needs improvement
 class Greedy {
@@ -13,60 +14,23 @@ public:
   static void solve(graph &g, unsigned int depth = 0) {
     if (!depth) depth = g.n;
     int n = g.n, contractions = 0;
-    while (g.n >= 2) {
-      std::pair<unsigned int, unsigned int> best_nodes = find_node_most_common_neighbors(g);
+    PairQueue<Delta> queue{g};
+    while (g.n >= 2 && !stop_requested()) {
+      std::pair<unsigned int, unsigned int> best_nodes = queue.top();
       g.contract(best_nodes.first, best_nodes.second);
+      queue.contracted(best_nodes.first, best_nodes.second);
       ++contractions;
       if (contractions == depth) break;
     }
   }
 
 private:
-  static int red_degree_delta(node const *u, node const *v) {
-    int red_deg_delta = 0;
-
-    edge *u_ptr{u->first};
-    edge *v_ptr{v->first};
-
-    while (u_ptr->is_edge && v_ptr->is_edge) {
-      if (u_ptr->target == v_ptr->target) {
-        if (u_ptr->red) --red_deg_delta;
-        u_ptr = u_ptr->next;
-        v_ptr = v_ptr->next;
-      } else if (u_ptr->target < v_ptr->target) {
-        ++red_deg_delta;
-        u_ptr = u_ptr->next;
-      } else {
-        ++red_deg_delta;
-        v_ptr = v_ptr->next;
-      }
-    }
-    while (u_ptr->is_edge) {
-      u_ptr = u_ptr->next;
-      ++red_deg_delta;
-    }
-    while (v_ptr->is_edge) {
-      v_ptr = v_ptr->next;
-      ++red_deg_delta;
+  // red degree delta of the pair in node order, i.e. the common red neighbors of the smaller node are subtracted
+  struct Delta {
+    static int score(PairScoring &scoring, node *marked, node *other, int cutoff) {
+      return scoring.red_degree_delta(other, cutoff, other->id < marked->id);
     }
-    return red_deg_delta;
-  }
-
-  static std::pair<unsigned int, unsigned int> find_node_most_common_neighbors(graph &g) {
-    int min = INT_MAX;
-    node *best_u, *best_v;
-    for (node *u = g.get_first_node(); u; u = u->next) {
-      for (node *v = u->next; v; v = v->next) {
-        int delta = red_degree_delta(u, v);
-        if (delta < min) {
-          min = delta;
-          best_u = u;
-          best_v = v;
-        }
-      }
-    }
-    return {best_u->id, best_v->id};
-  }
+  };
 };
 
 #endif /* end of include guard: GREEDY_HH */
@@ -0,0 +1,170 @@
+#ifndef GREEDY_LSH_HH
+#define GREEDY_LSH_HH
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/graph.hh"
+#include "../data_structures/minhash.hh"
+#include "../data_structures/pair_scoring.hh"
+#include "../utils.hh"
+
+/**
+ * @brief Greedy contraction of the pair with the lowest resulting red degree (like GreedyStrong), but only pairs
+ *        proposed by MinHash/LSH buckets of the neighborhoods are scored
+ *        suited for very large graphs, where scoring all pairs is infeasible
+ */
+class GreedyLSH {
+public:
+  static std::string name() { return "Greedy (LSH)"; }
+
+  static void solve(graph& g, Config& config) {
+    int depth = config.search_depth ? config.search_depth : g.n;
+    int contractions = 0;
+
+    Candidates candidates{g};
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    std::vector<unsigned int> partners;
+    std::vector<unsigned int> changed;
+
+    auto seed = [&]() {
+      // only buckets, that changed since the last seed, can have pairs, that were never queued
+      candidates.index.changed_candidates(pairs);
+      for (auto&& [u, v] : pairs) {
+        candidates.scoring.mark(&g.adj_list[u]);
+        candidates.push(u, v, candidates.scoring.red_degree(&g.adj_list[v]));
+      }
+    };
+    seed();
+
+    while (g.n >= 2 && contractions < depth && !stop_requested()) {
+      if (candidates.queue.empty()) seed();
+      unsigned int u, v;
+      if (candidates.queue.empty()) {
+        // no node shares a bucket with another one
+        u = g.get_first_node()->id;
+        v = g.get_first_node()->next->id;
+      } else {
+        unsigned int red_deg;
+        std::tie(red_deg, u, v) = candidates.queue.top();
+        candidates.queue.pop();
+        auto queued = candidates.queued.find(key(u, v));
+        // a lower score of the pair was pushed since
+        if (queued == candidates.queued.end() || queued->second != red_deg) continue;
+        if (!g.adj_list[u].active || !g.adj_list[v].active) {
+          candidates.queued.erase(queued);
+          continue;
+        }
+        // a higher score is updated lazily, lower scores are pushed once they change
+        candidates.scoring.mark(&g.adj_list[u]);
+        unsigned int current = candidates.scoring.red_degree(&g.adj_list[v]);
+        if (current != red_deg) {
+          queued->second = current;
+          candidates.queue.push({current, u, v});
+          continue;
+        }
+        candidates.queued.erase(queued);
+      }
+      candidates.contract(u, v);
+      ++contractions;
+      // propose pairs for all nodes with a changed signature
+      candidates.index.contracted(u, v, changed);
+      for (unsigned int id : changed) {
+        candidates.index.candidates(id, partners);
+        candidates.scoring.mark(&g.adj_list[id]);
+        for (unsigned int other : partners) {
+          candidates.push(id, other, candidates.scoring.red_degree(&g.adj_list[other]));
+        }
+      }
+    }
+  }
+
+private:
+  // red degree, u, v
+  using Candidate = std::tuple<unsigned int, unsigned int, unsigned int>;
+
+  static uint64_t key(unsigned int u, unsigned int v) {
+    return (uint64_t)std::min(u, v) << 32 | std::max(u, v);
+  }
+
+  /**
+   * @brief Queue of the proposed pairs by their score
+   *        the score of an entry is at most the red degree of its pair, so a popped pair, whose red degree equals its
+   *        score, is the best one, a pair is pushed again, whenever its score decreases, the entries with an older score
+   *        are skipped
+   */
+  struct Candidates {
+    graph& g;
+    MinHashIndex index{g};
+    PairScoring scoring{g};
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    // the last score pushed for each queued pair, and the queued partners of each node
+    std::unordered_map<uint64_t, unsigned int> queued;
+    std::vector<std::vector<unsigned int>> partners;
+    // nodes, whose pairs were already lowered for the current contraction, marked with the current stamp
+    std::vector<unsigned int> lowered;
+    unsigned int stamp = 0;
+    std::vector<unsigned int> affected;
+
+    Candidates(graph& g) : g(g), partners(g.adj_list.size()), lowered(g.adj_list.size(), 0) {}
+
+    /**
+     * @brief Contracts u and v and lowers the scores of the queued pairs, that may have a lower red degree now
+     *        red edges never lower a red degree, and the neighborhoods of u and of its other neighbors only get
+     *        red edges or no new nodes, so only v disappearing lowers the red degree of a pair, by at most one, if one
+     *        of its nodes is u or was adjacent to v, the pair is not scored again until it is popped
+     */
+    void contract(unsigned int u, unsigned int v) {
+      affected.assign(1, u);
+      for (auto&& e : g.adj_list[v]) {
+        if (e.target != u) affected.push_back(e.target);
+      }
+      g.contract(u, v);
+      ++stamp;
+      for (unsigned int id : affected) {
+        lower(id);
+        lowered[id] = stamp;
+      }
+    }
+
+    void push(unsigned int u, unsigned int v, unsigned int red_deg) {
+      if (u == v || !g.adj_list[u].active || !g.adj_list[v].active) return;
+      auto [it, inserted] = queued.try_emplace(key(u, v), red_deg);
+      if (inserted) {
+        partners[u].push_back(v);
+        partners[v].push_back(u);
+      } else if (red_deg < it->second) {
+        it->second = red_deg;
+      } else {
+        return;
+      }
+      queue.push({red_deg, std::min(u, v), std::max(u, v)});
+    }
+
+    /**
+     * @brief Pushes the queued pairs of a node again with a score lowered by one, that are still active and were not
+     *        lowered for the current contraction yet
+     */
+    void lower(unsigned int id) {
+      std::vector<unsigned int>& list = partners[id];
+      for (unsigned int i = 0; i < list.size();) {
+        unsigned int other = list[i];
+        auto it = queued.find(key(id, other));
+        if (!g.adj_list[other].active || it == queued.end()) {
+          list[i] = list.back();
+          list.pop_back();
+          continue;
+        }
+        if (it->second && lowered[other] != stamp) push(id, other, it->second - 1);
+        ++i;
+      }
+    }
+  };
+};
+
+#endif /* end of include guard: GREEDY_LSH_HH */
@@ -21,7 +21,7 @@ public:
     config.random = false;
     run_solver(g, c, Solver::GREEDY_STRONG);
 
-    for (int i = std::max<unsigned int>(initial_tww, g.twin_width); g.n > 1 && depth > 0; i++) {
+    for (int i = std::max<unsigned int>(initial_tww, g.twin_width); g.n > 1 && depth > 0 && !stop_requested(); i++) {
       // TODO: depth limit not respected by reductions
       unsigned int old_n = g.n;
       if (config.reduction_frequency && i % config.reduction_frequency == 0) {
@@ -6,12 +6,14 @@
 
 #include "../data_structures/graph.hh"
 #include "../reductions/degzero.hh"
+#include "../utils.hh"
 
 class Greedylth {
 public:
   static std::string name() { return "Greedylth"; }
 
   static void solve(graph &g) {
+    g.enable_degree_buckets();
     // zero degree node reduction
     int zero_deg_node = DegreeZeroReduction::reduce(g);
 
@@ -22,8 +24,8 @@ public:
     // zero_deg_node = TwinReduction::reduce(g, 0, zero_deg_node);
 
     int u, v, other_u, other_v;
-    u = find_node_min_deg(g.adj_list);
-    while ((other_u = find_node_min_deg(g.adj_list, u))) {
+    u = find_node_min_deg(g);
+    while (!stop_requested() && (other_u = find_node_min_deg(g, u))) {
       v = find_node_fewest_new_red_neighbors(u, g);
       other_v = find_node_fewest_new_red_neighbors(other_u, g);
       if (new_red_edges(other_u, other_v, g) < new_red_edges(u, v, g)) {
@@ -42,27 +44,20 @@ public:
         } else {
           zero_deg_node = u;
         }
-        u = find_node_min_deg(g.adj_list);
+        u = find_node_min_deg(g);
       }
     }
   }
 
 private:
-  static int find_node_min_deg(const std::vector<node> &nodes, int other = 0) {
-    int node{}, min{std::numeric_limits<int>::max()};
-    for (int i{1}; i < other; ++i) {
-      if (!nodes[i].active) continue;
-      if (nodes[i].deg >= min || !nodes[i].deg) continue;
-      min = nodes[i].deg;
-      node = i;
-    }
-    for (int i{other + 1}; i < nodes.size(); ++i) {
-      if (!nodes[i].active) continue;
-      if (nodes[i].deg >= min || !nodes[i].deg) continue;
-      min = nodes[i].deg;
-      node = i;
+  // node of minimum positive degree except other, nodes of degree zero are handled separately
+  static int find_node_min_deg(const graph &g, int other = 0) {
+    for (unsigned int deg = 1; deg <= g.degree_buckets.max_key(); ++deg) {
+      for (unsigned int id : g.degree_buckets.bucket(deg)) {
+        if (id != other) return id;
+      }
     }
-    return node;
+    return 0;
   }
 
   static int new_red_edges(int u, int v, const graph &g) {
@@ -0,0 +1,202 @@
+#ifndef INDUCED_SUBGRAPH_BOUND_HH
+#define INDUCED_SUBGRAPH_BOUND_HH
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/contraction_enumeration.hh"
+#include "../data_structures/graph.hh"
+#include "../data_structures/transposition_table.hh"
+#include "../reductions/twins.hh"
+#include "../utils.hh"
+
+/**
+ * @brief Lower bound engine, that solves small induced subgraphs exactly in its own threads, while the B&B runs
+ *        an induced subgraph of a trigraph has at most its tww, so the largest tww of a subgraph is a lower bound, the
+ *        B&B stops once it reaches the best tww (see BranchAndBound::search)
+ *        the subgraphs are grown from every node, by decreasing degree, once by the node with the most edges into the
+ *        subgraph, which gives dense neighborhoods, and once by the neighbor with the highest degree, which gives
+ *        high degree cores, once all nodes were seeds, the subgraphs grow by two nodes
+ */
+class InducedSubgraphBound {
+public:
+  // raised by the threads, never above the best tww at the start
+  std::atomic<unsigned int> bound;
+
+  /**
+   * @param g a graph, copied in its current state, its tww includes the contractions already applied
+   * @param tww best tww so far, no subgraph is searched beyond it
+   * @param lower_bound lower bound known so far
+   */
+  InducedSubgraphBound(graph &g, Config &config, unsigned int tww, unsigned int lower_bound)
+      : bound(std::max(lower_bound, g.twin_width)), upper(tww), size(config.subgraph_size), config(config) {
+    h.copy_from(g);
+    edges_into.resize(h.adj_list.size(), 0);
+    in.resize(h.adj_list.size(), false);
+    for (node *nd = h.get_first_node(); nd; nd = nd->next) {
+      seeds.push_back(nd->id);
+    }
+    std::stable_sort(seeds.begin(), seeds.end(),
+                     [&](unsigned int a, unsigned int b) { return h.adj_list[a].deg > h.adj_list[b].deg; });
+    for (int i = 0; i < config.subgraph_threads; ++i) {
+      threads.emplace_back([this]() { work(); });
+    }
+  }
+
+  InducedSubgraphBound(const InducedSubgraphBound &) = delete;
+
+  ~InducedSubgraphBound() {
+    stop = true;
+    for (auto &&thread : threads) {
+      thread.join();
+    }
+    std::cout << "c Induced subgraph lower bound: " << bound << " from " << solved << " subgraphs of up to " << size
+              << " nodes" << std::endl;
+  }
+
+private:
+  // the current state of the graph, only read by the threads
+  graph h;
+  unsigned int upper;
+  std::vector<unsigned int> seeds;
+  std::vector<std::thread> threads;
+  std::atomic<bool> stop{false};
+  std::atomic<unsigned int> solved{0};
+
+  // the next subgraph is grown from seeds[next_seed] by the rule densest, with size nodes, the subgraphs of one size
+  // are searched once
+  std::mutex mutex;
+  unsigned int size;
+  unsigned int next_seed = 0;
+  bool densest = true;
+  std::set<std::vector<unsigned int>> grown;
+  // buffers of grow(), all zero between two calls
+  std::vector<unsigned int> edges_into;
+  std::vector<bool> in;
+  std::vector<unsigned int> neighbors;
+  Config &config;
+
+  bool interrupted() { return stop || bound >= upper || stop_requested(); }
+
+  void work() {
+    std::vector<unsigned int> nodes;
+    // the subgraphs of a thread are searched one after the other, they reuse its table
+    TranspositionTable transpositions;
+    while (!interrupted() && next_subgraph(nodes)) {
+      unsigned int lower = bound;
+      // a subgraph with n nodes has at most n - 1 red edges at a node
+      if (nodes.size() <= lower + 1) continue;
+      graph subgraph;
+      subgraph.read_induced(h, nodes);
+      unsigned int tww = upper;
+      if (!search(subgraph, tww, lower, transpositions)) break;
+      ++solved;
+      unsigned int old = bound;
+      while (tww > old && !bound.compare_exchange_weak(old, tww)) {
+      }
+      if (tww > old) {
+        std::lock_guard<std::mutex> lock{mutex};
+        std::cout << "c Induced subgraph of " << nodes.size() << " nodes proved tww >= " << tww << std::endl;
+      }
+    }
+  }
+
+  /**
+   * @brief Grows the next subgraph, that was not searched yet
+   *
+   * @return false, once the subgraphs would contain the whole graph
+   */
+  bool next_subgraph(std::vector<unsigned int> &nodes) {
+    std::lock_guard<std::mutex> lock{mutex};
+    while (size < h.n) {
+      if (next_seed == seeds.size()) {
+        next_seed = 0;
+        size += 2;
+        grown.clear();
+        continue;
+      }
+      grow(seeds[next_seed], densest, nodes);
+      if (!densest) ++next_seed;
+      densest = !densest;
+      if (grown.insert(nodes).second) return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Grows a connected subgraph from seed, by the node with the most edges into it, or by its neighbor with the
+   *        highest degree, ties are broken by degree and id, only called with the mutex held, as it uses the buffers
+   */
+  void grow(unsigned int seed, bool densest, std::vector<unsigned int> &nodes) {
+    nodes = {seed};
+    in[seed] = true;
+    unsigned int last = seed;
+    while (nodes.size() < size) {
+      for (auto &&e : h.adj_list[last]) {
+        if (in[e.target]) continue;
+        if (!edges_into[e.target]++) neighbors.push_back(e.target);
+      }
+      auto better = [&](unsigned int a, unsigned int b) {
+        if (densest && edges_into[a] != edges_into[b]) return edges_into[a] > edges_into[b];
+        if (h.adj_list[a].deg != h.adj_list[b].deg) return h.adj_list[a].deg > h.adj_list[b].deg;
+        return a < b;
+      };
+      auto next = std::min_element(neighbors.begin(), neighbors.end(), better);
+      if (next == neighbors.end()) break;  // the component is complete
+      last = *next;
+      *next = neighbors.back();
+      neighbors.pop_back();
+      in[last] = true;
+      nodes.push_back(last);
+    }
+    // only the subgraph and its neighbors were touched
+    for (unsigned int id : nodes) {
+      in[id] = false;
+      edges_into[id] = 0;
+    }
+    for (unsigned int id : neighbors) edges_into[id] = 0;
+    neighbors.clear();
+    std::sort(nodes.begin(), nodes.end());
+  }
+
+  /**
+   * @brief Searches the optimal tww of a connected subgraph below tww, like the sequential search of BranchAndBound
+   *
+   * @param tww tww of the best solution, unchanged if there is none below it
+   * @param lower_bound the search stops, once a solution with this tww is found, it does not raise the bound
+   * @param transpositions table of the thread, cleared before the search
+   * @return false, if the search was interrupted
+   */
+  bool search(graph &g, unsigned int &tww, unsigned int lower_bound, TranspositionTable &transpositions) {
+    if (g.twin_width >= tww) return true;
+    ContractionEnumeration enumeration{g, 0, 1, config.order_contractions, config.normal_form};
+    transpositions.clear();
+    unsigned int twin_u, twin_v;
+    while (!interrupted() && enumeration.do_next_contraction(g, tww)) {
+      if (g.n == 1) {  // leaf
+        if (g.twin_width < tww) {
+          tww = g.twin_width;
+          if (tww <= lower_bound) break;
+        }
+      } else if (g.twin_width >= tww) {
+        enumeration.skip_branch(g);
+      } else if (!transpositions.visit(enumeration.state_hash(g), g.twin_width)) {
+        enumeration.skip_branch(g);
+      } else if (config.search_reductions &&
+                 TwinReduction::find_near(g, &g.adj_list[g.con_seq.back().u], twin_u, twin_v)) {
+        enumeration.force(g, twin_u, twin_v);
+      }
+    }
+    bool complete = tww <= lower_bound || !interrupted();
+    g.uncontract(g.con_seq.size());
+    return complete;
+  }
+};
+
+#endif /* end of include guard: INDUCED_SUBGRAPH_BOUND_HH */
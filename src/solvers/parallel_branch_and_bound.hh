@@ -0,0 +1,231 @@
+#ifndef PARALLEL_BRANCH_AND_BOUND_HH
+#define PARALLEL_BRANCH_AND_BOUND_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/checkpoint.hh"
+#include "../data_structures/contraction_enumeration.hh"
+#include "../data_structures/graph.hh"
+#include "../data_structures/transposition_table.hh"
+#include "../reductions/twins.hh"
+#include "../utils.hh"
+#include "cycle_detection.hh"
+
+/**
+ * @brief Branch and bound with several threads
+ *        each worker owns a copy of the graph and explores subtrees of the contraction enumeration, a subtree is given
+ *        by the contractions leading to it and the position in its first level, from which on the remaining
+ *        contractions belong to it
+ *        idle workers request work, busy workers answer by splitting off the remaining contractions of their shallowest
+ *        open level, the best tww is shared, so every worker prunes with the best solution found so far
+ *        to write a checkpoint, or to stop on request, all workers suspend their subtrees into the queue, which then
+ *        holds the complete state of the search
+ */
+class ParallelBranchAndBound {
+public:
+  /**
+   * @brief Searches for a contraction sequence with a tww lower than tww
+   *
+   * @param g a graph, that is not changed
+   * @param tww best tww so far, updated on improvement
+   * @param solution best solution so far, including the contractions already applied to g, updated on improvement
+   * @param lower_bound the search stops, once a solution with this tww is found
+   * @param checkpoint if given, the search continues its tasks, if it was resumed, and writes its state to it every
+   *                   config.checkpoint_interval seconds and when it is stopped
+   * @param shared_lower_bound lower bound, that other threads raise during the search, the search stops once it
+   *                           reaches the best tww, nullptr: none
+   */
+  static void search(graph &g, Config &config, unsigned int &tww, Solution &solution, unsigned int lower_bound = 0,
+                     Checkpoint *checkpoint = nullptr, const std::atomic<unsigned int> *shared_lower_bound = nullptr) {
+    Shared shared{g, config, solution};
+    shared.best = tww;
+    shared.lower_bound = lower_bound;
+    shared.shared_lower_bound = shared_lower_bound;
+    shared.checkpoint = checkpoint;
+    if (checkpoint && checkpoint->resumed) {
+      shared.tasks.assign(checkpoint->search().tasks.begin(), checkpoint->search().tasks.end());
+      shared.nodes = checkpoint->search().nodes;
+    } else {
+      // the root level starts like any other level, so it is ordered as well
+      shared.tasks.push_back({{}, {}, g.get_first_node()->id, g.get_first_node()->id});
+    }
+    shared.queued = shared.tasks.size();
+    shared.next_checkpoint = std::chrono::steady_clock::now() + std::chrono::seconds{config.checkpoint_interval};
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < config.threads; ++i) {
+      workers.emplace_back(work, std::ref(shared));
+    }
+    for (auto &&worker : workers) {
+      worker.join();
+    }
+    tww = shared.best;
+  }
+
+private:
+  using Task = SearchTask;
+
+  // nodes between two checks, whether a checkpoint is due
+  static constexpr unsigned long long CHECKPOINT_CHECK_NODES = 1024;
+
+  struct Shared {
+    graph &g;
+    Config &config;
+    Solution &solution;
+    // contractions already applied to g, before the search started
+    Solution root = g.build_solution();
+
+    std::atomic<unsigned int> best{};
+    unsigned int lower_bound = 0;
+    const std::atomic<unsigned int> *shared_lower_bound = nullptr;
+    std::atomic<bool> stop{false};
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    std::deque<Task> tasks{};
+    // number of workers waiting for a task and number of queued tasks, read without the mutex by busy workers
+    std::atomic<int> waiting{0};
+    std::atomic<int> queued{1};
+
+    Checkpoint *checkpoint = nullptr;
+    std::chrono::steady_clock::time_point next_checkpoint{};
+    // the workers hand their subtrees back to the queue and take no new tasks
+    std::atomic<bool> suspend{false};
+    std::atomic<unsigned long long> nodes{0};
+  };
+
+  static bool next_task(Shared &shared, Task &task) {
+    std::unique_lock<std::mutex> lock{shared.mutex};
+    ++shared.waiting;
+    while (true) {
+      shared.cv.wait(lock, [&]() {
+        return (!shared.tasks.empty() && !shared.suspend) || shared.waiting == shared.config.threads || shared.stop;
+      });
+      if (!shared.suspend || shared.stop) break;
+      // every worker is suspended, the queue is the complete state of the search
+      if (shared.checkpoint) write_checkpoint(shared);
+      shared.suspend = false;
+      if (stop_requested()) shared.stop = true;
+      shared.cv.notify_all();
+    }
+    if (shared.tasks.empty() || shared.stop) {
+      // every worker is idle, the search is finished
+      shared.cv.notify_all();
+      return false;
+    }
+    task = std::move(shared.tasks.front());
+    shared.tasks.pop_front();
+    --shared.queued;
+    --shared.waiting;
+    return true;
+  }
+
+  static void work(Shared &shared) {
+    unsigned int desired_n = shared.config.search_depth ? std::max<int>(shared.g.n - shared.config.search_depth, 1) : 1;
+    // other workers may read the original graph at the same time, but nobody changes it
+    graph g;
+    g.copy_from(shared.g);
+    ContractionEnumeration contraction_enumeration{g, shared.config.search_depth,
+                                                   (unsigned int)shared.config.candidate_threads,
+                                                   shared.config.order_contractions, shared.config.normal_form};
+    TranspositionTable transpositions;
+    Task task;
+    Task split;
+    unsigned int twin_u, twin_v;
+    unsigned long long nodes = 0;
+    while (next_task(shared, task)) {
+      contraction_enumeration.resume(g, task.prefix, task.prefix_forced, task.first, task.after, shared.best,
+                                     task.remaining, task.remaining_forced);
+      while (!shared.stop && !shared.suspend && contraction_enumeration.do_next_contraction(g, shared.best)) {
+        ++nodes;
+        if (g.n == desired_n) {  // leaf
+          if (g.twin_width < shared.best) improve(shared, g);
+        } else if (g.twin_width >= shared.best) {
+          contraction_enumeration.skip_branch(g);
+        } else if (!transpositions.visit(contraction_enumeration.state_hash(g), g.twin_width)) {
+          // the same state was already explored by this worker with at most the same twin width
+          contraction_enumeration.skip_branch(g);
+        } else if (shared.config.search_reductions &&
+                   TwinReduction::find_near(g, &g.adj_list[g.con_seq.back().u], twin_u, twin_v)) {
+          // the last contraction created twins, contracting them first is optimal
+          contraction_enumeration.force(g, twin_u, twin_v);
+        } else if (shared.waiting > shared.queued &&
+                   contraction_enumeration.split(g, split.prefix, split.prefix_forced, split.first, split.after,
+                                                 split.remaining)) {
+          std::lock_guard<std::mutex> lock{shared.mutex};
+          shared.tasks.push_back(split);
+          ++shared.queued;
+          shared.cv.notify_one();
+        }
+        if (stop_requested() || (shared.checkpoint && nodes % CHECKPOINT_CHECK_NODES == 0 &&
+                                 std::chrono::steady_clock::now() >= shared.next_checkpoint)) {
+          shared.suspend = true;
+        }
+        if (shared.shared_lower_bound && *shared.shared_lower_bound >= shared.best) {
+          // another thread proved the best tww optimal
+          std::lock_guard<std::mutex> lock{shared.mutex};
+          shared.stop = true;
+          shared.cv.notify_all();
+        }
+      }
+      if (shared.suspend && !shared.stop) {
+        std::lock_guard<std::mutex> lock{shared.mutex};
+        contraction_enumeration.suspend(g, [&](auto &prefix, auto &prefix_forced, unsigned int first,
+                                               unsigned int after, auto &remaining, bool remaining_forced) {
+          shared.tasks.push_back({prefix, prefix_forced, first, after, remaining, remaining_forced});
+          ++shared.queued;
+        });
+      }
+      g.uncontract(g.con_seq.size());
+      shared.nodes += nodes;
+      nodes = 0;
+    }
+  }
+
+  static void write_checkpoint(Shared &shared) {
+    Checkpoint::Search &state = shared.checkpoint->search();
+    state.tww = shared.best;
+    state.nodes = shared.nodes;
+    state.solution.assign(shared.solution.contractions.begin() + shared.root.contractions.size(),
+                          shared.solution.contractions.end());
+    state.tasks.assign(shared.tasks.begin(), shared.tasks.end());
+    shared.checkpoint->write();
+    shared.next_checkpoint =
+        std::chrono::steady_clock::now() + std::chrono::seconds{shared.config.checkpoint_interval};
+    std::cout << "c Checkpoint written with tww " << state.tww << ", " << state.tasks.size() << " open subtrees and "
+              << state.nodes << " nodes searched" << std::endl;
+  }
+
+  static void improve(Shared &shared, graph &g) {
+    std::lock_guard<std::mutex> lock{shared.mutex};
+    if (g.twin_width >= shared.best) return;
+    if (!shared.config.search_depth) {
+      std::cout << "c Branch and bound improved tww from " << shared.best << " to " << g.twin_width << std::endl;
+      // If tww 2 was reached, check for a cycle to stop
+      if (g.twin_width == 2 && CycleDetection::has_tww2_cycle(g)) {
+        shared.stop = true;
+        shared.cv.notify_all();
+      }
+    }
+    shared.best = g.twin_width;
+    if (shared.best <= shared.lower_bound) {
+      // the lower bound is reached, the solution is optimal
+      shared.stop = true;
+      shared.cv.notify_all();
+    }
+    shared.solution = shared.root;
+    for (auto &&con : g.con_seq) {
+      shared.solution.add_contraction(con.u, con.v);
+    }
+    shared.solution.twin_width = g.twin_width;
+  }
+};
+
+#endif /* end of include guard: PARALLEL_BRANCH_AND_BOUND_HH */
@@ -0,0 +1,320 @@
+#ifndef SAT_TWIN_WIDTH_HH
+#define SAT_TWIN_WIDTH_HH
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "../config/config.hh"
+#include "../data_structures/contraction_enumeration.hh"
+#include "../data_structures/graph.hh"
+#include "../sat/cdcl.hh"
+#include "../utils.hh"
+
+/**
+ * @brief Decides tww <= k by a SAT encoding of the contraction sequence of the current graph
+ *        step t contracts one node into a parent, that stays alive, the red edges after each step follow from the
+ *        red edges before it: a red edge of two alive nodes stays, the parent gets a red edge to every alive node, to
+ *        which the contracted node or the parent had a red edge, or to which exactly one of them is adjacent, as a
+ *        node, that has no red edge to another node, is adjacent to it, if and only if they were adjacent before
+ *        the red edges are only implied, so a model may have more of them than its sequence, which only makes the
+ *        bounds on the red degrees stricter
+ *        once k + 1 nodes are left, no contraction exceeds k, so the encoding has n - k - 1 steps for the lowest k
+ *        the red degrees are counted once, a selector literal per k bounds them, so the learnt clauses of one k are
+ *        kept for the next
+ */
+class SatTwinWidth {
+public:
+  static std::string name() { return "SatTwinWidth"; }
+
+  // the solver takes about 400 bytes per variable with its clauses, larger encodings are skipped
+  static constexpr unsigned long long max_variables = 1ULL << 21;
+
+  static void solve(graph &g, Config &) {
+    // the plain red deg limit heuristic gives the first k
+    int old_n = g.n;
+    Config c{};
+    c.strategy = Strategy::SOLVER;
+    c.solver = Solver::RED_DEG_LIMIT;
+    run_strategy(g, c, Strategy::SOLVER);
+    unsigned int tww = g.twin_width;
+    Solution solution = g.build_solution();
+    g.uncontract(old_n - g.n);
+    std::cout << "c Heuristic tww: " << tww << std::endl;
+
+    unsigned int lower_bound = g.n > 1 ? ContractionEnumeration::lookahead_bound(g, tww) : g.twin_width;
+    search(g, lower_bound, tww, solution, -1, false);
+
+    g.uncontract(g.con_seq.size());
+    for (auto &contr : solution.contractions) {
+      g.contract(contr.u, contr.v);
+    }
+  }
+
+  /**
+   * @brief Decides tww <= k for k between lower_bound and tww
+   *
+   * @param g a graph, that is not changed
+   * @param lower_bound lower bound on the tww, updated with the proven bounds
+   * @param tww best tww so far, updated on improvement
+   * @param solution best solution so far, including the contractions already applied to g, updated on improvement
+   * @param conflict_limit conflicts of each decision, negative for no limit
+   * @param ascending decide k from lower_bound upwards, which proves lower bounds, instead of from tww - 1 downwards
+   */
+  static void search(graph &g, unsigned int &lower_bound, unsigned int &tww, Solution &solution,
+                     long long conflict_limit, bool ascending) {
+    // the contractions already applied to g are part of every solution
+    lower_bound = std::max(lower_bound, g.twin_width);
+    if (lower_bound >= tww || g.n <= 1) return;
+    unsigned long long variables = Encoding::variables(g.n, lower_bound, tww);
+    if (variables > max_variables) {
+      std::cout << "c Skipping SAT encoding with " << variables << " variables, more than " << max_variables
+                << std::endl;
+      return;
+    }
+    Encoding encoding{g, lower_bound, tww};
+    std::cout << "c SAT encoding with " << encoding.solver.num_vars() << " variables for " << encoding.steps
+              << " steps" << std::endl;
+    unsigned int k = ascending ? lower_bound : tww - 1;
+    while (lower_bound < tww && !stop_requested()) {
+      auto result = encoding.solver.solve({CDCL::pos(encoding.selector(k))}, conflict_limit, stop_requested);
+      std::cout << "c SAT decision tww <= " << k << ": "
+                << (result == CDCL::SATISFIABLE ? "yes" : result == CDCL::UNSATISFIABLE ? "no" : "unknown") << ", "
+                << encoding.solver.conflicts << " conflicts" << std::endl;
+      if (result == CDCL::UNKNOWN) break;
+      if (result == CDCL::UNSATISFIABLE) {
+        lower_bound = k + 1;
+        ++k;
+      } else {
+        unsigned int found = encoding.apply_model(g, solution);
+        if (found < tww) {
+          std::cout << "c SAT improved tww from " << tww << " to " << found << std::endl;
+          tww = found;
+        }
+        k = tww - 1;
+      }
+    }
+  }
+
+private:
+  struct Encoding {
+    using Lit = CDCL::Lit;
+
+    CDCL solver;
+    // nodes of the graph, indexed by their position
+    std::vector<unsigned int> ids;
+    unsigned int m;
+    unsigned int steps;
+    unsigned int lowest_k;
+    // per step and position: contracted in this step, parent in this step, alive after this step
+    std::vector<int> contracted, parent, alive;
+    // per step and position: adjacent to the contracted node, adjacent to the parent, red edge to the contracted node
+    // before the step
+    std::vector<int> adjacent_contracted, adjacent_parent, red_to_contracted;
+    // per step and pair of positions: red edge after the step
+    std::vector<int> red;
+    // per k: the red degrees are at most k
+    std::vector<int> selectors;
+
+    /**
+     * @brief Variables of the encoding of a graph with m nodes: the variables per node and pair, the prefixes of the
+     *        two exactly one constraints and the counters of the red degrees in every step, and the selectors
+     */
+    static unsigned long long variables(unsigned long long m, unsigned int k_low, unsigned int k_high) {
+      unsigned long long steps = m > k_low + 1 ? m - k_low - 1 : 0;
+      // a counter of m - 1 red edges counts up to k_high
+      unsigned long long k = std::min<unsigned long long>(k_high, m - 1);
+      unsigned long long counters = k * (k + 1) / 2 + (m - 1 - k) * k;
+      return (steps + 1) * (6 * m + m * (m - 1) / 2) + steps * (2 * m + m * counters) + (k_high - k_low);
+    }
+
+    Encoding(graph &g, unsigned int k_low, unsigned int k_high) : lowest_k(k_low) {
+      for (node *nd = g.get_first_node(); nd; nd = nd->next) {
+        ids.push_back(nd->id);
+      }
+      m = ids.size();
+      steps = m > lowest_k + 1 ? m - lowest_k - 1 : 0;
+      std::vector<int> position(g.adj_list.size(), -1);
+      for (unsigned int i = 0; i < m; ++i) position[ids[i]] = i;
+      // black and red adjacency of the current graph
+      std::vector<char> black(m * m, 0), red_before(m * m, 0);
+      for (unsigned int i = 0; i < m; ++i) {
+        for (auto &&e : g.adj_list[ids[i]]) {
+          (e.red ? red_before : black)[i * m + position[e.target]] = 1;
+        }
+      }
+
+      auto vars = [&](std::vector<int> &v, size_t count) {
+        v.resize(count);
+        for (auto &&x : v) x = solver.new_var();
+      };
+      vars(contracted, (steps + 1) * m);
+      vars(parent, (steps + 1) * m);
+      vars(alive, (steps + 1) * m);
+      vars(adjacent_contracted, (steps + 1) * m);
+      vars(adjacent_parent, (steps + 1) * m);
+      vars(red_to_contracted, (steps + 1) * m);
+      red.resize((steps + 1) * m * m, -1);
+      for (unsigned int t = 0; t <= steps; ++t) {
+        for (unsigned int i = 0; i < m; ++i) {
+          for (unsigned int j = i + 1; j < m; ++j) red[(t * m + i) * m + j] = solver.new_var();
+        }
+      }
+      for (unsigned int i = 0; i < m; ++i) {
+        solver.add_clause({CDCL::pos(alive[i])});
+        for (unsigned int j = i + 1; j < m; ++j) {
+          solver.add_clause({red_before[i * m + j] ? CDCL::pos(red_var(0, i, j)) : CDCL::neg(red_var(0, i, j))});
+        }
+      }
+
+      for (unsigned int t = 1; t <= steps; ++t) {
+        // the contractions imply everything else, so the search decides them first
+        for (unsigned int v = 0; v < m; ++v) {
+          solver.set_priority(contracted[t * m + v], 1, true);
+          solver.set_priority(parent[t * m + v], 1, true);
+        }
+        std::vector<int> contracted_before = exactly_one(contracted, t);
+        exactly_one(parent, t);
+        // contracting the parent into the node gives the same graph, so the node comes first
+        solver.add_clause({CDCL::neg(parent[t * m])});
+        for (unsigned int v = 1; v < m; ++v) {
+          solver.add_clause({CDCL::neg(parent[t * m + v]), CDCL::pos(contracted_before[v - 1])});
+        }
+        for (unsigned int v = 0; v < m; ++v) {
+          int a = alive[t * m + v], before = alive[(t - 1) * m + v], c = contracted[t * m + v];
+          // alive after the step, if alive before and not contracted
+          solver.add_clause({CDCL::neg(a), CDCL::pos(before)});
+          solver.add_clause({CDCL::neg(a), CDCL::neg(c)});
+          solver.add_clause({CDCL::pos(a), CDCL::neg(before), CDCL::pos(c)});
+          solver.add_clause({CDCL::neg(c), CDCL::pos(before)});
+          solver.add_clause({CDCL::neg(parent[t * m + v]), CDCL::pos(a)});
+          for (unsigned int w = 0; w < m; ++w) {
+            if (w == v) continue;
+            // the adjacency of two nodes without a red edge is their adjacency in the graph
+            int ac = adjacent_contracted[t * m + w], ap = adjacent_parent[t * m + w];
+            solver.add_clause({CDCL::neg(c), black[v * m + w] ? CDCL::pos(ac) : CDCL::neg(ac)});
+            solver.add_clause({CDCL::neg(parent[t * m + v]), black[v * m + w] ? CDCL::pos(ap) : CDCL::neg(ap)});
+            solver.add_clause({CDCL::neg(c), CDCL::neg(red_var(t - 1, v, w)), CDCL::pos(red_to_contracted[t * m + w])});
+          }
+        }
+        for (unsigned int v = 0; v < m; ++v) {
+          for (unsigned int w = 0; w < m; ++w) {
+            if (w == v) continue;
+            Lit p = CDCL::neg(parent[t * m + v]), a = CDCL::neg(alive[t * m + w]), r = CDCL::pos(red_var(t, v, w));
+            int ac = adjacent_contracted[t * m + w], ap = adjacent_parent[t * m + w];
+            solver.add_clause({p, a, CDCL::neg(ac), CDCL::pos(ap), r});
+            solver.add_clause({p, a, CDCL::pos(ac), CDCL::neg(ap), r});
+            solver.add_clause({p, a, CDCL::neg(red_to_contracted[t * m + w]), r});
+            if (v < w) {
+              // red edges of alive nodes stay, and only alive nodes have red edges
+              solver.add_clause({CDCL::neg(red_var(t - 1, v, w)), CDCL::neg(alive[t * m + v]),
+                                 CDCL::neg(alive[t * m + w]), r});
+              solver.add_clause({CDCL::neg(red_var(t, v, w)), CDCL::pos(alive[t * m + v])});
+              solver.add_clause({CDCL::neg(red_var(t, v, w)), CDCL::pos(alive[t * m + w])});
+            }
+          }
+        }
+      }
+
+      // sequential counters of the red degrees up to k_high, the selector of k forbids a count of k + 1
+      for (unsigned int k = lowest_k; k < k_high; ++k) {
+        selectors.push_back(solver.new_var());
+      }
+      for (unsigned int t = 1; t <= steps; ++t) {
+        for (unsigned int v = 0; v < m; ++v) {
+          // count[c]: at least c of the red edges so far
+          std::vector<int> count(k_high + 1, -1);
+          unsigned int counted = 0;
+          for (unsigned int w = 0; w < m; ++w) {
+            if (w == v) continue;
+            Lit x = CDCL::neg(red_var(t, v, w));
+            ++counted;
+            std::vector<int> next(k_high + 1, -1);
+            for (unsigned int c = 1; c <= std::min(counted, k_high); ++c) {
+              next[c] = solver.new_var();
+              if (c == 1) {
+                solver.add_clause({x, CDCL::pos(next[c])});
+              } else {
+                solver.add_clause({x, CDCL::neg(count[c - 1]), CDCL::pos(next[c])});
+              }
+              if (count[c] != -1) solver.add_clause({CDCL::neg(count[c]), CDCL::pos(next[c])});
+            }
+            count.swap(next);
+          }
+          for (unsigned int k = lowest_k; k < k_high; ++k) {
+            if (count[k + 1] != -1) solver.add_clause({CDCL::neg(selectors[k - lowest_k]), CDCL::neg(count[k + 1])});
+          }
+        }
+      }
+    }
+
+    int selector(unsigned int k) const { return selectors[k - lowest_k]; }
+
+    int red_var(unsigned int t, unsigned int v, unsigned int w) const {
+      return v < w ? red[(t * m + v) * m + w] : red[(t * m + w) * m + v];
+    }
+
+    /**
+     * @return std::vector<int> per position: one of the positions up to it is true, as far as implied
+     */
+    std::vector<int> exactly_one(std::vector<int> &v, unsigned int t) {
+      std::vector<Lit> any;
+      std::vector<int> prefixes;
+      int previous = -1;
+      for (unsigned int i = 0; i < m; ++i) {
+        any.push_back(CDCL::pos(v[t * m + i]));
+        // sequential at most one: prefix is true, once one of the first nodes is
+        int prefix = solver.new_var();
+        prefixes.push_back(prefix);
+        solver.add_clause({CDCL::neg(v[t * m + i]), CDCL::pos(prefix)});
+        if (previous != -1) {
+          solver.add_clause({CDCL::neg(previous), CDCL::pos(prefix)});
+          solver.add_clause({CDCL::neg(previous), CDCL::neg(v[t * m + i])});
+        }
+        previous = prefix;
+      }
+      solver.add_clause(any);
+      return prefixes;
+    }
+
+    /**
+     * @brief Applies the contraction sequence of the model, contracts the remaining nodes in order and stores it, if
+     *        it is better than the solution
+     *
+     * @return unsigned int tww of the sequence
+     */
+    unsigned int apply_model(graph &g, Solution &solution) {
+      unsigned int old_size = g.con_seq.size();
+      // the graph keeps the smaller id of a contraction
+      std::vector<unsigned int> current = ids;
+      std::vector<char> gone(m, 0);
+      for (unsigned int t = 1; t <= steps; ++t) {
+        unsigned int u = m, p = m;
+        for (unsigned int v = 0; v < m; ++v) {
+          if (solver.model_value(contracted[t * m + v])) u = v;
+          if (solver.model_value(parent[t * m + v])) p = v;
+        }
+        g.contract(current[u], current[p]);
+        current[p] = std::min(current[u], current[p]);
+        gone[u] = 1;
+      }
+      unsigned int last = m;
+      for (unsigned int v = 0; v < m; ++v) {
+        if (gone[v]) continue;
+        if (last != m) {
+          g.contract(current[last], current[v]);
+          current[v] = std::min(current[last], current[v]);
+        }
+        last = v;
+      }
+      unsigned int found = g.twin_width;
+      if (found < (unsigned int)solution.twin_width) {
+        solution = g.build_solution();
+      }
+      g.uncontract(g.con_seq.size() - old_size);
+      return found;
+    }
+  };
+};
+
+#endif /* end of include guard: SAT_TWIN_WIDTH_HH */
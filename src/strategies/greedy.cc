@@ -4,18 +4,56 @@
 #include "../solvers/branch_and_bound.hh"
 #include "../utils.hh"
 
-void greedy_depth_limited_bb(graph& g, Config& config) {
+void greedy_depth_limited_bb(graph& g, Config& config,
+                             std::unordered_map<uint64_t, unsigned int>* window_bounds) {
+  if (config.rolling_horizon && config.search_depth) {
+    rolling_horizon_bb(g, config);
+    return;
+  }
   std::cout << "c Using depth limited B&B strategy with depth " << config.search_depth
             << (config.search_depth ? "" : " (variable)") << std::endl;
   int cnt = 0;
-  while (g.n > 1) {
+  while (g.n > 1 && !stop_requested()) {
     if (config.reduction_frequency && cnt % config.reduction_frequency == 0) {
       reduce(g, config);
     }
     // TODO: if search depth is 0, calculate dynamic depth
-    solve<BranchAndBound>(g, config);
+    solve<BranchAndBound>(g, config, window_bounds);
+    ++cnt;
+  }
+}
+
+void rolling_horizon_bb(graph& g, Config& config) {
+  std::cout << "c Using rolling horizon B&B strategy with depth " << config.search_depth << std::endl;
+  // contractions from the current state to a single node, the first is committed in every step
+  BranchAndBound::Plan plan;
+  unsigned int window_bound = 0;
+  int cnt = 0;
+  while (g.n > 1 && !stop_requested()) {
+    if (config.reduction_frequency && cnt % config.reduction_frequency == 0) {
+      unsigned int old_n = g.n;
+      reduce(g, config);
+      if (g.n != old_n) {
+        // the plan may contract nodes, that the reductions contracted
+        plan = {};
+        window_bound = 0;
+      }
+      if (g.n == 1) break;
+    }
+    BranchAndBound::improve_plan(g, config, plan, window_bound);
+    // a heuristic stopped before its first contraction leaves no plan
+    if (plan.contractions.empty()) break;
+    g.contract(plan.contractions.front().u, plan.contractions.front().v);
+    plan.contractions.pop_front();
+    if (plan.searched) --plan.searched;
     ++cnt;
   }
+  // a stopped search completes its plan
+  for (auto&& c : plan.contractions) {
+    if (g.n == 1) break;
+    g.contract(c.u, c.v);
+  }
+  std::cout << "c Rolling horizon B&B reached tww " << g.twin_width << " in " << cnt << " steps" << std::endl;
 }
 
 void single_solver(graph& g, Config& config) {
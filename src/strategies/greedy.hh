@@ -1,11 +1,21 @@
 #ifndef STRAT_GREEDY_HH
 #define STRAT_GREEDY_HH
 
+#include <cstdint>
+#include <unordered_map>
+
 #include "../config/config.hh"
 #include "../data_structures/graph.hh"
 #include "../utils.hh"
 
-void greedy_depth_limited_bb(graph& g, Config& config);
+/**
+ * @param window_bounds lower bounds on the windows of the states, shared by runs of increasing depth on the same graph,
+ *                      see BranchAndBound::solve
+ */
+void greedy_depth_limited_bb(graph& g, Config& config,
+                             std::unordered_map<uint64_t, unsigned int>* window_bounds = nullptr);
+
+void rolling_horizon_bb(graph& g, Config& config);
 
 void single_solver(graph& g, Config& config);
 
@@ -12,7 +12,7 @@ void local_search(graph& g, Config& config) {
   std::cout << "c Initial solver twin width: " << g.twin_width << std::endl;
   std::cerr << 0 << ";" << g.twin_width << std::endl;
 
-  for (int i = 1; i <= config.refinement_iterations; ++i) {
+  for (int i = 1; i <= config.refinement_iterations && !stop_requested(); ++i) {
     if (i % config.reduction_frequency == 0) {
       reduce(g, config);
     }
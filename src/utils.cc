@@ -1,6 +1,10 @@
 #include "utils.hh"
 
+#include <unistd.h>
+
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <stdexcept>
 #include <string>
 
@@ -10,11 +14,13 @@
 #include "reductions/reductions.hh"
 #include "solvers/branch_and_bound.hh"
 #include "solvers/greedy.hh"
+#include "solvers/greedy_lsh.hh"
 #include "solvers/greedy_red_deg_limit.hh"
 #include "solvers/greedy_strong.hh"
 #include "solvers/greedylth.hh"
 #include "solvers/heuristic.hh"
 #include "solvers/ordered.hh"
+#include "solvers/sat_twin_width.hh"
 #include "solvers/tree_contract.hh"
 #include "strategies/greedy.hh"
 #include "strategies/local_search.hh"
@@ -54,6 +60,12 @@ void reduce(graph &g, Config &config) {
   std::cout << "c Reductions;" << old_n << ";" << g.n << ";" << (g.n / (double)old_n) << std::endl;
 }
 
+void complete_stopped(graph &g) {
+  if (g.n <= 1 || !stop_requested()) return;
+  std::cout << "c Stop requested, contracting the remaining " << g.n << " nodes in order" << std::endl;
+  Ordered::solve(g);
+}
+
 void run_solver(graph &g, Config &config, Solver solver) {
   auto start = std::chrono::high_resolution_clock::now();
   switch (solver) {
@@ -84,9 +96,17 @@ void run_solver(graph &g, Config &config, Solver solver) {
     case Solver::HEURISTIC:
       solve<Heuristic>(g, config);
       break;
+    case Solver::GREEDY_LSH:
+      solve<GreedyLSH>(g, config);
+      break;
+    case Solver::SAT:
+      solve<SatTwinWidth>(g, config);
+      break;
     default:
       throw std::invalid_argument("Solver not covered");
   }
+  // only reductions leave the remaining nodes to the caller on purpose
+  if (solver != Solver::ONLY_REDUCTIONS) complete_stopped(g);
   auto end = std::chrono::high_resolution_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
   std::cout << "c Solver " << get_solver_name(solver) << " ran in " << ((double)duration.count()) / 1e6
@@ -107,6 +127,7 @@ void run_strategy(graph &g, Config &config, Strategy strategy) {
     default:
       throw std::invalid_argument("Strategy not covered");
   }
+  complete_stopped(g);
 }
 
 void solve_complement_components(graph &g, Config &config) {
@@ -171,3 +192,19 @@ void write_solution(graph &g, Solution &solution) {
     g.contract(c.u, c.v);
   }
 }
+
+// written by the signal handler, so it has to be lock-free
+static std::atomic<bool> stop_signal{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+static void handle_stop_signal(int) { stop_signal = true; }
+
+void enable_stop_signals(int time_limit) {
+  std::signal(SIGTERM, handle_stop_signal);
+  std::signal(SIGALRM, handle_stop_signal);
+  if (time_limit > 0) {
+    alarm(time_limit);
+  }
+}
+
+bool stop_requested() { return stop_signal; }
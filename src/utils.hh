@@ -63,4 +63,18 @@ void solve_components(graph &g, Config &config);
 
 void write_solution(graph &g, Solution& solution);
 
+/**
+ * @brief Makes SIGTERM and SIGALRM request a stop, and sends SIGALRM after time_limit seconds, if it is not 0
+ *        solvers check stop_requested() and return their best complete solution early, which is then printed as usual
+ */
+void enable_stop_signals(int time_limit);
+
+bool stop_requested();
+
+/**
+ * @brief Completes the partial solution of a stopped solver or strategy as fast as possible, so every caller gets a
+ *        single node
+ */
+void complete_stopped(graph &g);
+
 #endif
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "data_structures/contraction_enumeration.hh"
+#include "data_structures/graph.hh"
+
+/**
+ * @brief Reads a random graph with n nodes, each edge is present with probability p
+ */
+static void read_random(graph &g, unsigned int n, double p, std::mt19937 &rng) {
+  std::bernoulli_distribution edge{p};
+  std::stringstream edges;
+  unsigned int m = 0;
+  for (unsigned int u = 1; u <= n; ++u) {
+    for (unsigned int v = u + 1; v <= n; ++v) {
+      if (edge(rng)) {
+        edges << u << " " << v << "\n";
+        ++m;
+      }
+    }
+  }
+  std::stringstream input;
+  input << "p tww " << n << " " << m << "\n" << edges.str();
+  std::streambuf *old = std::cin.rdbuf(input.rdbuf());
+  g.read_from_stdin();
+  std::cin.rdbuf(old);
+}
+
+/**
+ * @brief Reads disjoint paths with the given numbers of nodes
+ */
+static void read_paths(graph &g, const std::vector<unsigned int> &lengths) {
+  std::stringstream edges;
+  unsigned int n = 0, m = 0;
+  for (unsigned int length : lengths) {
+    for (unsigned int i = 1; i < length; ++i) {
+      edges << n + i << " " << n + i + 1 << "\n";
+      ++m;
+    }
+    n += length;
+  }
+  std::stringstream input;
+  input << "p tww " << n << " " << m << "\n" << edges.str();
+  std::streambuf *old = std::cin.rdbuf(input.rdbuf());
+  g.read_from_stdin();
+  std::cin.rdbuf(old);
+}
+
+/**
+ * @brief Tries every pair of active nodes in every state, independent of the contraction enumeration
+ *
+ * @param best exclusive upper bound
+ * @return unsigned int optimal tww, or best if it is not below best
+ */
+static unsigned int brute_force_tww(graph &g, unsigned int best) {
+  if (g.n == 1) return g.twin_width;
+  std::vector<unsigned int> active;
+  for (node *nd = g.get_first_node(); nd; nd = nd->next) {
+    active.push_back(nd->id);
+  }
+  for (unsigned int i = 0; i < active.size(); ++i) {
+    for (unsigned int j = i + 1; j < active.size(); ++j) {
+      g.contract(active[i], active[j]);
+      if (g.twin_width < best) best = brute_force_tww(g, best);
+      g.uncontract();
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Counts the states with a tww below limit, the limit is fixed, so the count does not depend on the order, in
+ *        which solutions are found
+ */
+static unsigned long long states_below(graph &g, bool ordered, bool normal_form, unsigned int limit) {
+  ContractionEnumeration enumeration{g, 0, 1, ordered, normal_form};
+  unsigned long long nodes = 0;
+  while (enumeration.do_next_contraction(g, limit)) {
+    ++nodes;
+  }
+  g.uncontract(g.con_seq.size());
+  return nodes;
+}
+
+/**
+ * @brief Enumerates all contraction sequences like the sequential B&B without transposition table and reductions
+ *
+ * @param nodes number of enumerated states
+ * @return unsigned int optimal tww
+ */
+static unsigned int optimal_tww(graph &g, bool ordered, bool normal_form, unsigned long long &nodes) {
+  unsigned int tww = g.n;
+  ContractionEnumeration enumeration{g, 0, 1, ordered, normal_form};
+  nodes = 0;
+  while (enumeration.do_next_contraction(g, tww)) {
+    ++nodes;
+    if (g.n == 1) {
+      if (g.twin_width < tww) tww = g.twin_width;
+    } else if (g.twin_width >= tww) {
+      enumeration.skip_branch(g);
+    }
+  }
+  g.uncontract(g.con_seq.size());
+  return tww;
+}
+
+/**
+ * @brief Compares the optimal tww found by the enumeration in Foata normal form and the plain enumeration with a brute
+ *        force search on small random graphs, the normal form only drops reorderings of independent contractions, so
+ *        all have to agree
+ *        on disjoint paths most contractions are independent, there the normal form has to visit strictly fewer
+ *        states than the plain enumeration, which only drops adjacent independent contractions in the wrong order
+ */
+int main() {
+  std::mt19937 rng{42};
+  unsigned int failures = 0;
+  unsigned long long plain_nodes = 0, normal_form_nodes = 0;
+  for (unsigned int round = 0; round < 300; ++round) {
+    unsigned int n = 4 + round % 6;
+    double p = 0.2 + 0.15 * (round / 6 % 5);
+    graph g;
+    read_random(g, n, p, rng);
+    unsigned int optimum = brute_force_tww(g, g.n);
+    for (bool ordered : {false, true}) {
+      unsigned long long plain, normal_form;
+      unsigned int expected = optimal_tww(g, ordered, false, plain);
+      unsigned int tww = optimal_tww(g, ordered, true, normal_form);
+      plain_nodes += plain;
+      normal_form_nodes += normal_form;
+      if (tww != optimum || expected != optimum) {
+        ++failures;
+        std::cout << "round " << round << " (n = " << n << ", ordered = " << ordered << "): normal form tww " << tww
+                  << ", plain tww " << expected << ", optimum " << optimum << std::endl;
+      }
+    }
+  }
+  std::cout << "plain enumeration: " << plain_nodes << " states, normal form: " << normal_form_nodes << " states"
+            << std::endl;
+  for (const std::vector<unsigned int> &lengths :
+       std::vector<std::vector<unsigned int>>{{2, 3, 4}, {3, 3, 3}, {2, 2, 3, 3}, {3, 3, 4}, {2, 2, 2, 2, 2}}) {
+    graph g;
+    read_paths(g, lengths);
+    for (bool ordered : {false, true}) {
+      // below 2 there are hardly any states to drop
+      unsigned long long plain = states_below(g, ordered, false, 2);
+      unsigned long long normal_form = states_below(g, ordered, true, 2);
+      std::cout << "paths of " << g.n << " nodes (ordered = " << ordered << "): plain enumeration " << plain
+                << " states, normal form " << normal_form << " states" << std::endl;
+      if (normal_form >= plain) ++failures;
+    }
+  }
+  return failures ? 1 : 0;
+}